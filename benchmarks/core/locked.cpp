@@ -0,0 +1,134 @@
+// Copyright (C) 2024 Arthur LAURENT <arthur.laurent4@gmail.com>
+// This file is subject to the license terms in the LICENSE file
+// found in the top-level of this distribution
+
+import std;
+
+import stormkit.core;
+import stormkit.bench;
+
+using namespace stormkit;
+
+namespace {
+    /// Small read-mostly state, e.g. a camera
+    struct Camera {
+        std::array<f32, 3> position = {};
+        std::array<f32, 4> rotation = {};
+        f32                fov      = 90.f;
+    };
+
+    constexpr auto READS_PER_THREAD = 100'000uz;
+
+    /// `state.size()` reader threads call `read()` READS_PER_THREAD times, with one more thread
+    /// writing in a loop if `with_writer` is set. Thread creation is not measured
+    template<class Read, class Write>
+    auto run_readers(bench::State& state, Read&& read, Write&& write, bool with_writer) -> void {
+        const auto reader_count = state.size();
+
+        auto start   = std::barrier { as<std::ptrdiff_t>(reader_count + 1) };
+        auto done    = std::barrier { as<std::ptrdiff_t>(reader_count + 1) };
+        auto stop    = std::atomic<bool> { false };
+        auto threads = std::vector<std::jthread> {};
+        threads.reserve(reader_count + 1);
+
+        for (auto _ : range(reader_count))
+            threads.emplace_back([&] {
+                start.arrive_and_wait();
+                for (auto _ : range(READS_PER_THREAD)) bench::do_not_optimize(read());
+                done.arrive_and_wait();
+            });
+
+        if (with_writer)
+            threads.emplace_back([&] {
+                auto i = 0.f;
+                while (not stop.load(std::memory_order_relaxed)) write(i++);
+            });
+
+        state.set_items_per_sample(reader_count * READS_PER_THREAD);
+        state.measure([&] {
+            start.arrive_and_wait();
+            done.arrive_and_wait();
+        });
+
+        stop.store(true, std::memory_order_relaxed);
+    }
+
+    auto mutex_readers(bench::State& state, bool with_writer) -> void {
+        auto locked = Locked<Camera> {};
+        run_readers(
+          state,
+          [&locked] { return locked.copy(); },
+          [&locked](f32 fov) { locked.write()->fov = fov; },
+          with_writer);
+    }
+
+    auto seqlock_readers(bench::State& state, bool with_writer) -> void {
+        auto locked = SeqLocked<Camera> {};
+        run_readers(
+          state,
+          [&locked] { return locked.load(); },
+          [&locked](f32 fov) { locked.update([fov](auto& camera) noexcept { camera.fov = fov; }); },
+          with_writer);
+    }
+
+    auto rcu_readers(bench::State& state, bool with_writer) -> void {
+        auto locked = RcuLocked<Camera> {};
+        run_readers(
+          state,
+          [&locked] { return locked.read()->fov; },
+          [&locked](f32 fov) { locked.update([fov](auto& camera) noexcept { camera.fov = fov; }); },
+          with_writer);
+    }
+
+    /// `state.size()` threads access a Locked<T> READS_PER_THREAD times each, one access out of
+    /// `write_every` is a write
+    auto mutex_contention(bench::State& state, usize write_every) -> void {
+        const auto thread_count = state.size();
+
+        auto locked  = Locked<Camera> {};
+        auto start   = std::barrier { as<std::ptrdiff_t>(thread_count + 1) };
+        auto done    = std::barrier { as<std::ptrdiff_t>(thread_count + 1) };
+        auto threads = std::vector<std::jthread> {};
+        threads.reserve(thread_count);
+
+        for (auto _ : range(thread_count))
+            threads.emplace_back([&] {
+                start.arrive_and_wait();
+                for (auto i : range(READS_PER_THREAD)) {
+                    if (i % write_every == 0) locked.write()->fov = static_cast<f32>(i);
+                    else bench::do_not_optimize(locked.read()->fov);
+                }
+                done.arrive_and_wait();
+            });
+
+        state.set_items_per_sample(thread_count * READS_PER_THREAD);
+        state.measure([&] {
+            start.arrive_and_wait();
+            done.arrive_and_wait();
+        });
+    }
+
+    auto _ = bench::BenchmarkSuite {
+        "Core.parallelism",
+        {
+          { "Locked.read",
+           [](bench::State& state) static { mutex_readers(state, false); } },
+          { "SeqLocked.read",
+           [](bench::State& state) static { seqlock_readers(state, false); } },
+          { "RcuLocked.read",
+           [](bench::State& state) static { rcu_readers(state, false); } },
+          { "Locked.read_with_writer",
+           [](bench::State& state) static { mutex_readers(state, true); } },
+          { "SeqLocked.read_with_writer",
+           [](bench::State& state) static { seqlock_readers(state, true); } },
+          { "RcuLocked.read_with_writer",
+           [](bench::State& state) static { rcu_readers(state, true); } },
+          { "Locked.write_contention",
+           [](bench::State& state) static { mutex_contention(state, 1); } },
+          { "Locked.mixed_10_percent_writes",
+           [](bench::State& state) static { mutex_contention(state, 10); } },
+          },
+        // sizes are reader (or accessing) thread counts
+        { 1, 2, 4, 8, 16, 32, 64 },
+    };
+} // namespace
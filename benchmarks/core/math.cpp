@@ -0,0 +1,392 @@
+// Copyright (C) 2024 Arthur LAURENT <arthur.laurent4@gmail.com>
+// This file is subject to the license terms in the LICENSE file
+// found in the top-level of this distribution
+
+import std;
+
+import stormkit.core;
+import stormkit.bench;
+
+using namespace stormkit;
+
+// Per instruction set comparison, build with `xmake f --simd=none|sse4|avx2`, save a run with
+// `--csv --output=<file>` and pass it to the next build with `--compare=<file>`, the run exits
+// with 1 when a regression is found
+
+namespace {
+    constexpr auto SAMPLES_PER_RUN = 16uz;
+
+    /// Element counts, the inputs fit in L1, L2 and L3
+    const auto SIZES = std::vector<std::size_t> { 64, 1'024, 16'384 };
+
+    /// Call `func(i)` for each element of the run, one item per element
+    template<class Func>
+    auto run(bench::State& state, Func&& func) -> void {
+        state.set_items_per_sample(state.size());
+        for (auto _ : range(SAMPLES_PER_RUN))
+            state.measure([&func, size = state.size()] {
+                for (auto i : range(size)) func(i);
+            });
+    }
+
+    /// Call `func()` once per sample, for the kernels taking the whole span
+    template<class Func>
+    auto run_batch(bench::State& state, Func&& func) -> void {
+        state.set_items_per_sample(state.size());
+        for (auto _ : range(SAMPLES_PER_RUN)) state.measure(func);
+    }
+
+    auto make_vec3s(usize count, f32 offset) -> std::vector<math::vec3f> {
+        return std::views::iota(0uz, count)
+               | std::views::transform([offset](auto i) {
+                     const auto value = as<f32>(i) * 0.01f + offset;
+                     return math::vec3f { value, 1.f - value, 0.5f + value * 2.f };
+                 })
+               | std::ranges::to<std::vector>();
+    }
+
+    auto make_vec4s(usize count, f32 offset) -> std::vector<math::vec4f> {
+        return make_vec3s(count, offset)
+               | std::views::transform([](const auto& vec) static {
+                     return math::vec4f { vec.x, vec.y, vec.z, 1.f };
+                 })
+               | std::ranges::to<std::vector>();
+    }
+
+    /// Affine transforms, the scale factors are at least 1 so every matrix is inversible
+    auto make_mats(usize count, f32 offset) -> std::vector<math::mat4x4f> {
+        return make_vec3s(count, offset)
+               | std::views::transform([](const auto& vec) static {
+                     const auto rotation = math::rotate(math::mat4x4f::identity(),
+                                                        math::radians(vec.x * 90.f),
+                                                        math::normalize(vec));
+                     const auto factors  = math::vec3f { 1.f + std::abs(vec.x),
+                                                         1.f + std::abs(vec.y),
+                                                         1.f + std::abs(vec.z) };
+                     return math::translate(math::scale(rotation, factors), vec);
+                 })
+               | std::ranges::to<std::vector>();
+    }
+
+    auto make_quats(usize count, f32 offset) -> std::vector<math::quatf> {
+        return make_vec3s(count, offset)
+               | std::views::transform([](const auto& vec) static {
+                     return math::from_axis_angle(math::normalize(vec),
+                                                  math::radians(vec.x * 90.f));
+                 })
+               | std::ranges::to<std::vector>();
+    }
+
+    auto make_factors(usize count) -> std::vector<f32> {
+        return std::views::iota(0uz, count)
+               | std::views::transform([count](auto i) { return as<f32>(i) / as<f32>(count); })
+               | std::ranges::to<std::vector>();
+    }
+
+    /// Angles in [-2pi, 2pi[
+    auto make_angles(usize count) -> std::vector<f32> {
+        return make_factors(count)
+               | std::views::transform([](auto t) static {
+                     return (t * 4.f - 2.f) * std::numbers::pi_v<f32>;
+                 })
+               | std::ranges::to<std::vector>();
+    }
+
+    /// Each node is the child of the previous one, roots every 16 nodes
+    auto make_parents(usize count) -> std::vector<u32> {
+        return std::views::iota(0uz, count)
+               | std::views::transform([](auto i) static {
+                     return (i % 16 == 0) ? math::NO_PARENT : as<u32>(i - 1);
+                 })
+               | std::ranges::to<std::vector>();
+    }
+
+    template<class T>
+    auto finish(const std::vector<T>& out) -> void {
+        bench::do_not_optimize(out.front());
+    }
+
+    auto instruction_set = bench::BenchmarkContext {
+        "Core math instruction set",
+        std::string { math::simd::as_string(math::simd::INSTRUCTION_SET) },
+    };
+
+    auto linear_suite = bench::BenchmarkSuite {
+        "Core.math.linear",
+        {
+          { "mat4x4f.mul",
+           [](bench::State& state) static {
+               const auto a   = make_mats(state.size(), 0.f);
+               const auto b   = make_mats(state.size(), 1.f);
+               auto       out = std::vector<math::mat4x4f>(state.size());
+               run(state, [&](auto i) { out[i] = math::mul(a[i], b[i]); });
+               finish(out);
+           } },
+          { "mat4x4f.inverse",
+           [](bench::State& state) static {
+               // a projection is not affine, so the general inverse is timed
+               const auto a = make_mats(state.size(), 0.f)
+                              | std::views::transform([](const auto& mat) static {
+                                    return math::mul(mat,
+                                                     math::perspective(math::radians(60.f),
+                                                                       1.5f,
+                                                                       0.1f,
+                                                                       100.f));
+                                })
+                              | std::ranges::to<std::vector>();
+               auto out = std::vector<math::mat4x4f>(state.size());
+               run(state, [&](auto i) { out[i] = math::inverse(a[i]); });
+               finish(out);
+           } },
+          { "mat4x4f.inverse_affine",
+           [](bench::State& state) static {
+               const auto a   = make_mats(state.size(), 0.f);
+               auto       out = std::vector<math::mat4x4f>(state.size());
+               run(state, [&](auto i) { out[i] = math::inverse_affine(a[i]); });
+               finish(out);
+           } },
+          { "mat4x4f.transpose",
+           [](bench::State& state) static {
+               const auto a   = make_mats(state.size(), 0.f);
+               auto       out = std::vector<math::mat4x4f>(state.size());
+               run(state, [&](auto i) { out[i] = math::transpose(a[i]); });
+               finish(out);
+           } },
+          { "mat4x4f.determinant",
+           [](bench::State& state) static {
+               const auto a   = make_mats(state.size(), 0.f);
+               auto       out = std::vector<f32>(state.size());
+               run(state, [&](auto i) { out[i] = math::determinant(a[i]); });
+               finish(out);
+           } },
+          { "mat4x4f.look_at",
+           [](bench::State& state) static {
+               const auto eyes    = make_vec3s(state.size(), 5.f);
+               const auto centers = make_vec3s(state.size(), -1.f);
+               auto       out     = std::vector<math::mat4x4f>(state.size());
+               run(state, [&](auto i) {
+                   out[i] = math::look_at(eyes[i], centers[i], math::vec3f { 0.f, 1.f, 0.f });
+               });
+               finish(out);
+           } },
+          { "mat4x4f.perspective",
+           [](bench::State& state) static {
+               const auto fovs = make_factors(state.size());
+               auto       out  = std::vector<math::mat4x4f>(state.size());
+               run(state, [&](auto i) {
+                   out[i] = math::perspective(math::radians(30.f + fovs[i] * 60.f),
+                                              16.f / 9.f,
+                                              0.1f,
+                                              1000.f);
+               });
+               finish(out);
+           } },
+          { "vec4f.mul_mat4x4f",
+           [](bench::State& state) static {
+               const auto a   = make_vec4s(state.size(), 0.f);
+               const auto b   = make_mats(state.size(), 1.f);
+               auto       out = std::vector<math::vec4f>(state.size());
+               run(state, [&](auto i) { out[i] = math::mul(a[i], b[i]); });
+               finish(out);
+           } },
+          { "vec3f.normalize",
+           [](bench::State& state) static {
+               const auto a   = make_vec3s(state.size(), 0.f);
+               auto       out = std::vector<math::vec3f>(state.size());
+               run(state, [&](auto i) { out[i] = math::normalize(a[i]); });
+               finish(out);
+           } },
+          { "vec4f.normalize",
+           [](bench::State& state) static {
+               const auto a   = make_vec4s(state.size(), 0.f);
+               auto       out = std::vector<math::vec4f>(state.size());
+               run(state, [&](auto i) { out[i] = math::normalize(a[i]); });
+               finish(out);
+           } },
+          { "vec3f.cross",
+           [](bench::State& state) static {
+               const auto a   = make_vec3s(state.size(), 0.f);
+               const auto b   = make_vec3s(state.size(), 1.f);
+               auto       out = std::vector<math::vec3f>(state.size());
+               run(state, [&](auto i) { out[i] = math::cross(a[i], b[i]); });
+               finish(out);
+           } },
+          { "vec4f.dot",
+           [](bench::State& state) static {
+               const auto a   = make_vec4s(state.size(), 0.f);
+               const auto b   = make_vec4s(state.size(), 1.f);
+               auto       out = std::vector<f32>(state.size());
+               run(state, [&](auto i) { out[i] = math::dot(a[i], b[i]); });
+               finish(out);
+           } },
+          },
+        SIZES,
+    };
+
+    auto hypercomplex_suite = bench::BenchmarkSuite {
+        "Core.math.hypercomplex",
+        {
+          { "quatf.mul",
+           [](bench::State& state) static {
+               const auto a   = make_quats(state.size(), 0.f);
+               const auto b   = make_quats(state.size(), 1.f);
+               auto       out = std::vector<math::quatf>(state.size());
+               run(state, [&](auto i) { out[i] = math::mul(a[i], b[i]); });
+               finish(out);
+           } },
+          { "quatf.normalize",
+           [](bench::State& state) static {
+               const auto a   = make_quats(state.size(), 0.f);
+               auto       out = std::vector<math::quatf>(state.size());
+               run(state, [&](auto i) { out[i] = math::normalize(a[i]); });
+               finish(out);
+           } },
+          { "quatf.normalize_fast",
+           [](bench::State& state) static {
+               const auto a   = make_quats(state.size(), 0.f);
+               auto       out = std::vector<math::quatf>(state.size());
+               run(state, [&](auto i) { out[i] = math::normalize<math::Precision::Fast>(a[i]); });
+               finish(out);
+           } },
+          { "quatf.nlerp",
+           [](bench::State& state) static {
+               const auto a   = make_quats(state.size(), 0.f);
+               const auto b   = make_quats(state.size(), 1.f);
+               const auto t   = make_factors(state.size());
+               auto       out = std::vector<math::quatf>(state.size());
+               run(state, [&](auto i) { out[i] = math::nlerp(a[i], b[i], t[i]); });
+               finish(out);
+           } },
+          { "quatf.slerp",
+           [](bench::State& state) static {
+               const auto a   = make_quats(state.size(), 0.f);
+               const auto b   = make_quats(state.size(), 1.f);
+               const auto t   = make_factors(state.size());
+               auto       out = std::vector<math::quatf>(state.size());
+               run(state, [&](auto i) { out[i] = math::slerp(a[i], b[i], t[i]); });
+               finish(out);
+           } },
+          { "quatf.slerp_fast",
+           [](bench::State& state) static {
+               const auto a   = make_quats(state.size(), 0.f);
+               const auto b   = make_quats(state.size(), 1.f);
+               const auto t   = make_factors(state.size());
+               auto       out = std::vector<math::quatf>(state.size());
+               run(state, [&](auto i) {
+                   out[i] = math::slerp<math::Precision::Fast>(a[i], b[i], t[i]);
+               });
+               finish(out);
+           } },
+          { "quatf.rotate",
+           [](bench::State& state) static {
+               const auto a   = make_quats(state.size(), 0.f);
+               const auto b   = make_vec3s(state.size(), 1.f);
+               auto       out = std::vector<math::vec3f>(state.size());
+               run(state, [&](auto i) { out[i] = math::rotate(a[i], b[i]); });
+               finish(out);
+           } },
+          { "quatf.to_mat4x4",
+           [](bench::State& state) static {
+               const auto a   = make_quats(state.size(), 0.f);
+               auto       out = std::vector<math::mat4x4f>(state.size());
+               run(state, [&](auto i) { out[i] = math::to_mat4x4(a[i]); });
+               finish(out);
+           } },
+          },
+        SIZES,
+    };
+
+    /// Batch kernels process the whole span in one call, compare them with the loops above
+    auto batch_suite = bench::BenchmarkSuite {
+        "Core.math.batch",
+        {
+          { "transform_points",
+           [](bench::State& state) static {
+               const auto points = make_vec3s(state.size(), 0.f);
+               const auto mat    = make_mats(1, 1.f).front();
+               auto       out    = std::vector<math::vec3f>(state.size());
+               run_batch(state, [&] { math::transform_points(points, mat, out); });
+               finish(out);
+           } },
+          { "transform_points.aosoa",
+           [](bench::State& state) static {
+               const auto mat    = make_mats(1, 1.f).front();
+               auto       blocks = std::vector<math::vec3x8f>(
+                 math::aosoa_block_count(state.size()));
+               math::to_aosoa(make_vec3s(state.size(), 0.f), blocks);
+               auto out = blocks;
+               run_batch(state, [&] { math::transform_points(blocks, mat, out); });
+               finish(out);
+           } },
+          { "mul_batch",
+           [](bench::State& state) static {
+               const auto a   = make_mats(state.size(), 0.f);
+               const auto b   = make_mats(state.size(), 1.f);
+               auto       out = std::vector<math::mat4x4f>(state.size());
+               run_batch(state, [&] { math::mul_batch(a, b, out); });
+               finish(out);
+           } },
+          { "local_to_world",
+           [](bench::State& state) static {
+               const auto local   = make_mats(state.size(), 0.f);
+               const auto parents = make_parents(state.size());
+               auto       out     = std::vector<math::mat4x4f>(state.size());
+               run_batch(state, [&] { math::local_to_world(local, parents, out); });
+               finish(out);
+           } },
+          { "quatf.normalize_batch",
+           [](bench::State& state) static {
+               const auto a   = make_quats(state.size(), 0.f);
+               auto       out = std::vector<math::quatf>(state.size());
+               run_batch(state, [&] { math::normalize_batch(a, out, math::Precision::Fast); });
+               finish(out);
+           } },
+          { "quatf.nlerp_batch",
+           [](bench::State& state) static {
+               const auto a   = make_quats(state.size(), 0.f);
+               const auto b   = make_quats(state.size(), 1.f);
+               const auto t   = make_factors(state.size());
+               auto       out = std::vector<math::quatf>(state.size());
+               run_batch(state, [&] { math::nlerp_batch(a, b, t, out); });
+               finish(out);
+           } },
+          { "quatf.slerp_batch_fast",
+           [](bench::State& state) static {
+               const auto a   = make_quats(state.size(), 0.f);
+               const auto b   = make_quats(state.size(), 1.f);
+               const auto t   = make_factors(state.size());
+               auto       out = std::vector<math::quatf>(state.size());
+               run_batch(state, [&] { math::slerp_batch(a, b, t, out, math::Precision::Fast); });
+               finish(out);
+           } },
+          { "quatf.to_mat4x4_batch",
+           [](bench::State& state) static {
+               const auto a   = make_quats(state.size(), 0.f);
+               auto       out = std::vector<math::mat4x4f>(state.size());
+               run_batch(state, [&] { math::to_mat4x4_batch(a, out); });
+               finish(out);
+           } },
+          { "sincos_batch",
+           [](bench::State& state) static {
+               const auto angles = make_angles(state.size());
+               auto       sin    = std::vector<f32>(state.size());
+               auto       cos    = std::vector<f32>(state.size());
+               run_batch(state, [&] { math::sincos_batch(angles, sin, cos); });
+               finish(sin);
+               finish(cos);
+           } },
+          { "sincos_batch_fast",
+           [](bench::State& state) static {
+               const auto angles = make_angles(state.size());
+               auto       sin    = std::vector<f32>(state.size());
+               auto       cos    = std::vector<f32>(state.size());
+               run_batch(state, [&] {
+                   math::sincos_batch(angles, sin, cos, math::Precision::Fast);
+               });
+               finish(sin);
+               finish(cos);
+           } },
+          },
+        SIZES,
+    };
+} // namespace
@@ -0,0 +1,160 @@
+// Copyright (C) 2024 Arthur LAURENT <arthur.laurent4@gmail.com>
+// This file is subject to the license terms in the LICENSE file
+// found in the top-level of this distribution
+
+import std;
+
+import stormkit.core;
+import stormkit.bench;
+
+using namespace stormkit;
+
+namespace {
+    constexpr auto TASK_COUNT       = 100'000uz;
+    constexpr auto LATENCY_SAMPLES  = 1'000uz;
+    constexpr auto ELEMENT_COUNT    = 1'000'000uz;
+    constexpr auto PRODUCER_WORKERS = 4u;
+
+    /// Attach the pool counters, summed or maxed over the workers, to the benchmark result
+    auto report(bench::State& state, const ThreadPool& pool) -> void {
+        auto executed   = u64 { 0 };
+        auto stolen     = u64 { 0 };
+        auto queue_hwm  = u64 { 0 };
+        auto inject_hwm = u64 { 0 };
+        auto idle       = std::chrono::nanoseconds {};
+        auto delay      = std::chrono::nanoseconds {};
+        auto max_delay  = std::chrono::nanoseconds {};
+        for (auto&& worker : pool.stats()) {
+            executed += worker.executed_tasks;
+            stolen += worker.stolen_tasks;
+            idle += worker.idle_time;
+            delay += worker.total_start_delay;
+            queue_hwm  = std::max(queue_hwm, worker.queue_high_water_mark);
+            inject_hwm = std::max(inject_hwm, worker.injected_high_water_mark);
+            max_delay  = std::max(max_delay, worker.max_start_delay);
+        }
+
+        state.set_counter("executed", as<f64>(executed));
+        state.set_counter("stolen", as<f64>(stolen));
+        state.set_counter("queue_hwm", as<f64>(queue_hwm));
+        state.set_counter("injected_hwm", as<f64>(inject_hwm));
+        state.set_counter("idle_us", as<f64>(idle.count()) / 1'000.);
+        state.set_counter("start_delay_mean_ns",
+                          (executed > 0) ? as<f64>(delay.count()) / as<f64>(executed) : 0.);
+        state.set_counter("start_delay_max_ns", as<f64>(max_delay.count()));
+    }
+
+    /// Time from the post of a task to its start, one sample per task. `state.size()` is the
+    /// worker count
+    auto submit_latency(bench::State& state) -> void {
+        auto pool = ThreadPool { as<u32>(state.size()) };
+
+        auto started = std::atomic<bool> { false };
+        for (auto _ : range(LATENCY_SAMPLES)) {
+            started.store(false, std::memory_order_relaxed);
+            state.measure([&] {
+                pool.post_task<void>([&started] { started.store(true, std::memory_order_release); },
+                                     ThreadPool::NoFuture);
+                while (not started.load(std::memory_order_acquire)) {}
+            });
+        }
+        state.set_items_per_sample(1);
+    }
+
+    /// Cost of scheduling a task doing nothing, posted from outside or from inside the pool
+    auto empty_tasks(bench::State& state, bool nested) -> void {
+        auto pool = ThreadPool { ThreadPool::Config { .worker_count  = as<u32>(state.size()),
+                                                      .collect_stats = true } };
+
+        auto done = std::latch { as<std::ptrdiff_t>(TASK_COUNT) };
+        state.set_items_per_sample(TASK_COUNT);
+        state.measure([&] {
+            const auto post_all = [&pool, &done] {
+                for (auto _ : range(TASK_COUNT))
+                    pool.post_task<void>([&done] { done.count_down(); }, ThreadPool::NoFuture);
+            };
+
+            if (nested) pool.post_task<void>(post_all, ThreadPool::NoFuture);
+            else post_all();
+
+            done.wait();
+        });
+
+        report(state, pool);
+    }
+
+    /// `state.size()` external threads post TASK_COUNT tasks in total
+    auto producers(bench::State& state) -> void {
+        const auto producer_count = state.size();
+        const auto per_producer   = TASK_COUNT / producer_count;
+        const auto total          = per_producer * producer_count;
+
+        auto pool    = ThreadPool { ThreadPool::Config { .worker_count  = PRODUCER_WORKERS,
+                                                         .collect_stats = true } };
+        auto start   = std::barrier { as<std::ptrdiff_t>(producer_count + 1) };
+        auto done    = std::latch { as<std::ptrdiff_t>(total) };
+        auto threads = std::vector<std::jthread> {};
+        threads.reserve(producer_count);
+
+        for (auto _ : range(producer_count))
+            threads.emplace_back([&] {
+                start.arrive_and_wait();
+                for (auto _ : range(per_producer))
+                    pool.post_task<void>([&done] { done.count_down(); }, ThreadPool::NoFuture);
+            });
+
+        state.set_items_per_sample(total);
+        state.measure([&] {
+            start.arrive_and_wait();
+            done.wait();
+        });
+
+        report(state, pool);
+    }
+
+    /// Scaling curve of parallel_for over a fixed amount of work, `state.size()` is the worker
+    /// count
+    auto parallel_for_scaling(bench::State& state, usize grain) -> void {
+        auto pool   = ThreadPool { as<u32>(state.size()) };
+        auto values = std::vector<f32>(ELEMENT_COUNT, 2.f);
+
+        state.set_items_per_sample(ELEMENT_COUNT);
+        state.measure([&] {
+            parallel_for(
+              pool,
+              values,
+              [](f32& value) static noexcept { value = std::sqrt(value * value + 1.f); },
+              grain);
+        });
+        bench::do_not_optimize(values.front());
+    }
+
+    auto worker_suite = bench::BenchmarkSuite {
+        "Core.parallelism",
+        {
+          { "ThreadPool.submit_latency",
+           [](bench::State& state) static { submit_latency(state); } },
+          { "ThreadPool.empty_task",
+           [](bench::State& state) static { empty_tasks(state, false); } },
+          { "ThreadPool.empty_task_nested",
+           [](bench::State& state) static { empty_tasks(state, true); } },
+          { "parallel_for.scaling",
+           [](bench::State& state) static {
+               parallel_for_scaling(state, DEFAULT_PARALLEL_GRAIN);
+           } },
+          { "parallel_for.scaling_fine_grain",
+           [](bench::State& state) static { parallel_for_scaling(state, 64); } },
+          },
+        // sizes are worker counts
+        { 1, 2, 4, 8, 16 },
+    };
+
+    auto producer_suite = bench::BenchmarkSuite {
+        "Core.parallelism",
+        {
+          { "ThreadPool.producers", [](bench::State& state) static { producers(state); } },
+          },
+        // sizes are producer thread counts, the pool has PRODUCER_WORKERS workers
+        { 1, 2, 4, 8, 16 },
+    };
+} // namespace
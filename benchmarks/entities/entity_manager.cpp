@@ -0,0 +1,206 @@
+// Copyright (C) 2024 Arthur LAURENT <arthur.laurent4@gmail.com>
+// This file is subject to the license terms in the LICENSE file
+// found in the top-level of this distribution
+
+import std;
+
+import stormkit.core;
+import stormkit.entities;
+import stormkit.bench;
+
+using namespace stormkit;
+using namespace stormkit::entities::literals;
+
+namespace {
+    struct PositionComponent: entities::Component {
+        static constexpr Type TYPE = "PositionComponent"_component_type;
+
+        f32 x = 0.f;
+        f32 y = 0.f;
+    };
+
+    struct VelocityComponent: entities::Component {
+        static constexpr Type TYPE = "VelocityComponent"_component_type;
+
+        f32 dx = 1.f;
+        f32 dy = 1.f;
+    };
+
+    class MoveSystem final: public entities::System {
+      public:
+        explicit MoveSystem(u32 priority, entities::EntityManager& manager)
+            : System { manager,
+                       priority,
+                       { PositionComponent::TYPE, VelocityComponent::TYPE },
+                       { .reads  = { VelocityComponent::TYPE },
+                         .writes = { PositionComponent::TYPE } } },
+              m_world { &manager } {}
+
+        auto update(Secondf) -> void override {
+            for (auto e : m_entities) {
+                auto&       position = m_world->getComponent<PositionComponent>(e);
+                const auto& velocity = m_world->read_component<VelocityComponent>(e);
+                position.x += velocity.dx;
+                position.y += velocity.dy;
+            }
+        }
+
+      protected:
+        auto on_message_received(const entities::Message&) -> void override { ++received; }
+
+      private:
+        entities::EntityManager* m_world;
+        usize                    received = 0;
+    };
+
+    /// Only receive the membership messages, its update is empty so a step measure the flush
+    class ListenerSystem final: public entities::System {
+      public:
+        explicit ListenerSystem(u32 priority, entities::EntityManager& manager)
+            : System { manager, priority, { PositionComponent::TYPE, VelocityComponent::TYPE } } {}
+
+        auto update(Secondf) -> void override {}
+
+      protected:
+        auto on_message_received(const entities::Message& message) -> void override {
+            received += std::size(message.entities);
+        }
+
+      private:
+        usize received = 0;
+    };
+
+    struct DamageEvent: entities::Event {
+        static constexpr Type TYPE = "DamageEvent"_event_type;
+
+        entities::Entity target = entities::INVALID_ENTITY;
+        u32              amount = 0;
+    };
+
+    constexpr auto SYSTEM_COUNT = 8u;
+
+    auto populate(entities::EntityManager& manager, usize count, bool with_velocity)
+      -> std::vector<entities::Entity> {
+        auto handles = std::vector<entities::Entity> {};
+        handles.reserve(count);
+
+        for (auto _ : range(count)) {
+            const auto e = manager.make_entity();
+            manager.add_component<PositionComponent>(e);
+            if (with_velocity) manager.add_component<VelocityComponent>(e);
+
+            handles.emplace_back(e);
+        }
+        manager.step(Secondf { 0.f });
+
+        return handles;
+    }
+
+    auto _ = bench::BenchmarkSuite {
+        "Entities",
+        {
+          { "EntityManager.create_destroy",
+           [](bench::State& state) static {
+               auto manager = entities::EntityManager {};
+               auto handles = std::vector<entities::Entity> {};
+               handles.reserve(state.size());
+
+               state.set_items_per_sample(state.size());
+               state.measure([&] {
+                   for (auto _ : range(state.size())) handles.emplace_back(manager.make_entity());
+                   for (auto e : handles) manager.destroy_entity(e);
+                   manager.step(Secondf { 0.f });
+               });
+           } },
+          { "EntityManager.component_churn",
+           [](bench::State& state) static {
+               auto       manager = entities::EntityManager {};
+               const auto handles = populate(manager, state.size(), false);
+
+               state.set_items_per_sample(state.size());
+               state.measure([&] {
+                   for (auto e : handles) manager.add_component<VelocityComponent>(e);
+                   for (auto e : handles) manager.destroy_component<VelocityComponent>(e);
+                   manager.step(Secondf { 0.f });
+               });
+           } },
+          { "EntityManager.view_single",
+           [](bench::State& state) static {
+               auto manager = entities::EntityManager {};
+               populate(manager, state.size(), false);
+
+               state.set_items_per_sample(state.size());
+               state.measure([&] {
+                   auto sum = 0.f;
+                   for (auto&& [position] : std::as_const(manager).view<PositionComponent>())
+                       sum += position.x;
+                   bench::do_not_optimize(sum);
+               });
+           } },
+          { "EntityManager.view_multi",
+           [](bench::State& state) static {
+               auto       manager = entities::EntityManager {};
+               const auto handles = populate(manager, state.size(), false);
+               // only half of the entities match, the smallest storage drive the iteration
+               for (auto&& [i, e] : handles | std::views::enumerate)
+                   if (i % 2 == 0) manager.add_component<VelocityComponent>(e);
+
+               state.set_items_per_sample(state.size() / 2);
+               state.measure([&] {
+                   for (auto&& [position, velocity] :
+                        manager.view<PositionComponent, const VelocityComponent>()) {
+                       position.x += velocity.dx;
+                       position.y += velocity.dy;
+                   }
+                   bench::do_not_optimize(manager);
+               });
+           } },
+          { "EntityManager.step_systems",
+           [](bench::State& state) static {
+               auto manager = entities::EntityManager {};
+               for (auto i : range(SYSTEM_COUNT)) manager.add_system<MoveSystem>(i, manager);
+               populate(manager, state.size(), true);
+
+               state.set_items_per_sample(state.size() * SYSTEM_COUNT);
+               state.measure([&] { manager.step(Secondf { 0.f }); });
+           } },
+          { "EntityManager.message_dispatch",
+           [](bench::State& state) static {
+               auto manager = entities::EntityManager {};
+               for (auto i : range(SYSTEM_COUNT)) manager.add_system<ListenerSystem>(i, manager);
+               const auto handles = populate(manager, state.size(), true);
+
+               // the membership changes are recorded outside of the timed region, a sample only
+               // pay for the flush which match the entities against the systems and notify them
+               state.set_items_per_sample(state.size());
+               for (auto e : handles) manager.destroy_component<VelocityComponent>(e);
+               state.measure([&] { manager.step(Secondf { 0.f }); });
+
+               for (auto e : handles) manager.add_component<VelocityComponent>(e);
+               state.measure([&] { manager.step(Secondf { 0.f }); });
+           } },
+          { "EventChannel.publish_iterate",
+           [](bench::State& state) static {
+               auto manager = entities::EntityManager {};
+               manager.subscribe<DamageEvent>();
+               // grow the channel to the run size first, a steady event rate never allocate
+               for (auto _ : range(state.size())) manager.publish(DamageEvent {});
+               manager.step(Secondf { 0.f });
+
+               state.set_items_per_sample(state.size());
+               state.measure([&] {
+                   for (auto i : range(state.size())) {
+                       auto event   = DamageEvent {};
+                       event.amount = as<u32>(i);
+                       manager.publish(std::move(event));
+                   }
+                   manager.step(Secondf { 0.f });
+
+                   auto sum = u64 { 0 };
+                   for (const auto& event : manager.events<DamageEvent>()) sum += event.amount;
+                   bench::do_not_optimize(sum);
+               });
+           } },
+          },
+    };
+} // namespace
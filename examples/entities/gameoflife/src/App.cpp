@@ -143,7 +143,7 @@ auto App::handleMouse(const stormkit::wsi::MouseButtonPushedEventData& event) ->
 
     const auto cells = m_entities.entities_with_component<PositionComponent>();
     const auto it    = std::ranges::find_if(cells, [&](const auto e) {
-        const auto& position = m_entities.getComponent<PositionComponent>(e);
+        const auto& position = m_entities.read_component<PositionComponent>(e);
 
         return position.x == x && position.y == y;
     });
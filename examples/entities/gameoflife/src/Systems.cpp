@@ -57,7 +57,7 @@ auto UpdateBoardSystem::update(stormkit::Secondf delta) -> void {
     });
 
     for (const auto e : m_entities) {
-        const auto& position = m_manager->getComponent<PositionComponent>(e);
+        const auto& position = m_manager->read_component<PositionComponent>(e);
 
         auto it
             = std::ranges::find_if(cell_status, [x = position.x, y = position.y](const auto& cell) {
@@ -158,9 +158,7 @@ auto UpdateBoardSystem::post_update() -> void {
             pixel[3]   = 255_b;
         }
 
-        for (const auto e : m_entities) {
-            const auto& position = m_manager->getComponent<PositionComponent>(e);
-
+        for (auto&& [position] : std::as_const(*m_manager).view<PositionComponent>()) {
             auto pixel = board.pixel({ position.x, position.y, 0 });
             pixel[0]   = 255_b;
             pixel[1]   = 255_b;
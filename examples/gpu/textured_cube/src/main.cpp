@@ -645,9 +645,9 @@ auto main(std::span<const std::string_view> args) -> int {
 
         // update viewer data and upload
         const auto time   = stdc::duration_cast<SecondF>(current_time - start_time).count();
-        viewer_data.model = math::rotate(math::mat4f::identity(),
-                                         time * math::radians(90.f),
-                                         math::vec3f { 0.f, 1.f, 0.f });
+        viewer_data.model = math::rotate<math::Precision::Fast>(math::mat4f::identity(),
+                                                                time * math::radians(90.f),
+                                                                math::vec3f { 0.f, 1.f, 0.f });
 
         auto& viewer_buffer = submission_resource.viewer_buffer;
         viewer_buffer.upload(viewer_data);
@@ -0,0 +1,36 @@
+// Copryright (C) 2022 Arthur LAURENT <arthur.laurent4@gmail.com>
+// This file is subject to the license terms in the LICENSE file
+// found in the top-level of this distribution
+
+#ifndef STORMKIT_SIMD_MACRO_HPP
+#define STORMKIT_SIMD_MACRO_HPP
+
+// define STORMKIT_NO_SIMD to build the scalar kernels only
+#if not defined(STORMKIT_NO_SIMD)
+    #if defined(__AVX2__)
+        #define STORMKIT_SIMD_AVX2
+    #endif
+
+    #if defined(__SSE4_1__) or defined(__AVX__)
+        #define STORMKIT_SIMD_SSE4
+    #elif defined(__ARM_NEON) and (defined(__aarch64__) or defined(_M_ARM64))
+        #define STORMKIT_SIMD_NEON
+    #endif
+
+    // AVX2 doesn't imply FMA, -mavx2 alone doesn't define __FMA__
+    #if defined(__FMA__) or defined(STORMKIT_SIMD_NEON)
+        #define STORMKIT_SIMD_FMA
+    #endif
+#endif
+
+#if defined(STORMKIT_SIMD_SSE4) or defined(STORMKIT_SIMD_NEON)
+    #define STORMKIT_SIMD
+#endif
+
+#if defined(STORMKIT_SIMD_SSE4)
+    #include <immintrin.h>
+#elif defined(STORMKIT_SIMD_NEON)
+    #include <arm_neon.h>
+#endif
+
+#endif
@@ -17,6 +17,9 @@ namespace stormkit::engine {
     auto FrameGraphBuilder::bake() -> void {
         expects(not m_baked);
 
+        if (not m_bake_arena) m_bake_arena = std::make_unique<FrameArena>();
+        m_bake_arena->reset();
+
         for (auto& task : m_tasks)
             task.m_ref_count = std::size(task.creates()) + std::size(task.writes());
 
@@ -117,7 +120,8 @@ namespace stormkit::engine {
     /////////////////////////////////////
     /////////////////////////////////////
     auto FrameGraphBuilder::buildPhysicalDescriptions() noexcept -> void {
-        auto layouts = HashMap<GraphID, gpu::ImageLayout> {};
+        // transient bookkeeping only lives for the bake, keep it off the global heap
+        auto layouts = pmr::HashMap<GraphID, gpu::ImageLayout> { m_bake_arena.get() };
         m_preprocessed_framegraph
             = m_tasks
               | std::views::filter([](const auto& task) noexcept {
@@ -218,8 +222,8 @@ namespace stormkit::engine {
     /////////////////////////////////////
     auto FrameGraphBuilder::buildRenderPassPhysicalDescription(
         const GraphTask&                    task,
-        HashMap<GraphID, gpu::ImageLayout>& layouts) noexcept -> RenderPassData {
-        auto to_remove = std::vector<GraphID> {};
+        pmr::HashMap<GraphID, gpu::ImageLayout>& layouts) noexcept -> RenderPassData {
+        auto to_remove = std::pmr::vector<GraphID> { layouts.get_allocator() };
 
         const auto creates
             = task.creates()
@@ -0,0 +1,16 @@
+// Copyright (C) 2024 Arthur LAURENT <arthur.laurent4@gmail.com>
+// This file is subject to the license terms in the LICENSE file
+// found in the top-level of this distribution
+
+import stormkit.core;
+import stormkit.bench;
+
+import std;
+
+#include <stormkit/main/main_macro.hpp>
+
+auto main(std::span<const std::string_view> args) noexcept -> int {
+    bench::parse_args(args);
+
+    return bench::runBenchmarks();
+}
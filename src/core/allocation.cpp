@@ -0,0 +1,547 @@
+// Copyright (C) 2024 Arthur LAURENT <arthur.laurent4@gmail.com>
+// This file is subject to the license terms in the LICENSE file
+// found in the top-level of this distribution
+
+module;
+
+#include <stormkit/core/contract_macro.hpp>
+#include <stormkit/core/platform_macro.hpp>
+
+module stormkit.core;
+
+import std;
+
+namespace stormkit {
+    namespace {
+        constexpr auto SIZE_CLASS_COUNT = details::POOL_MAX_BLOCK_SIZE / details::POOL_BLOCK_SIZE;
+        /// Blocks a thread keep for itself before giving some back to the shared lists, workers
+        /// free the tasks submitters allocate so the blocks have to flow back
+        constexpr auto LOCAL_CACHE_SIZE = 256u;
+
+        struct FreeBlock {
+            FreeBlock* next;
+        };
+
+        /////////////////////////////////////
+        /////////////////////////////////////
+        STORMKIT_FORCE_INLINE
+        inline auto size_class_of(usize size) noexcept -> usize {
+            return (size - 1) / details::POOL_BLOCK_SIZE;
+        }
+
+        /////////////////////////////////////
+        /////////////////////////////////////
+        STORMKIT_FORCE_INLINE
+        inline auto new_block(usize size) -> void* {
+            return ::operator new(size, std::align_val_t { details::POOL_BLOCK_SIZE });
+        }
+
+        /////////////////////////////////////
+        /////////////////////////////////////
+        STORMKIT_FORCE_INLINE
+        inline auto delete_block(void* ptr) noexcept -> void {
+            ::operator delete(ptr, std::align_val_t { details::POOL_BLOCK_SIZE });
+        }
+
+        /// Lock-free lists only pushed to and emptied at once, so they are not subject to ABA
+        struct SharedFreeLists {
+            ~SharedFreeLists() noexcept {
+                for (auto& head : heads)
+                    for (auto* block = head.exchange(nullptr); block != nullptr;)
+                        delete_block(std::exchange(block, block->next));
+            }
+
+            auto push(usize size_class, FreeBlock* first, FreeBlock* last) noexcept -> void {
+                auto& head = heads[size_class];
+                auto  next = head.load(std::memory_order_relaxed);
+                do {
+                    last->next = next;
+                } while (not head.compare_exchange_weak(next,
+                                                        first,
+                                                        std::memory_order_release,
+                                                        std::memory_order_relaxed));
+            }
+
+            auto take_all(usize size_class) noexcept -> FreeBlock* {
+                auto& head = heads[size_class];
+                if (head.load(std::memory_order_relaxed) == nullptr) return nullptr;
+
+                return head.exchange(nullptr, std::memory_order_acquire);
+            }
+
+            std::array<std::atomic<FreeBlock*>, SIZE_CLASS_COUNT> heads = {};
+        };
+
+        constinit auto shared_free_lists = SharedFreeLists {};
+
+        struct LocalFreeLists {
+            ~LocalFreeLists() noexcept {
+                for (const auto i : range(SIZE_CLASS_COUNT))
+                    if (counts[i] > 0) spill(i, counts[i]);
+            }
+
+            auto spill(usize size_class, u32 count) noexcept -> void {
+                auto* first = heads[size_class];
+                auto* last  = first;
+                for (auto _ : range(count - 1)) last = last->next;
+
+                heads[size_class] = std::exchange(last->next, nullptr);
+                counts[size_class] -= count;
+
+                shared_free_lists.push(size_class, first, last);
+            }
+
+            std::array<FreeBlock*, SIZE_CLASS_COUNT> heads  = {};
+            std::array<u32, SIZE_CLASS_COUNT>        counts = {};
+        };
+
+        thread_local constinit auto local_free_lists = LocalFreeLists {};
+
+        /////////////////////////////////////
+        /////////////////////////////////////
+        STORMKIT_FORCE_INLINE
+        constexpr auto align_up(usize value, usize alignment) noexcept -> usize {
+            return (value + alignment - 1) & ~(alignment - 1);
+        }
+
+        /////////////////////////////////////
+        /////////////////////////////////////
+        STORMKIT_FORCE_INLINE
+        inline auto align_up(std::byte* ptr, usize alignment) noexcept -> std::byte* {
+            const auto address = std::bit_cast<std::uintptr_t>(ptr);
+
+            return ptr + (align_up(address, alignment) - address);
+        }
+    } // namespace
+
+    namespace details {
+        /////////////////////////////////////
+        /////////////////////////////////////
+        auto pool_allocate(usize size) -> void* {
+            if (size > POOL_MAX_BLOCK_SIZE) [[unlikely]]
+                return new_block(size);
+
+            const auto size_class = size_class_of(size);
+            auto&      local      = local_free_lists;
+
+            if (local.heads[size_class] == nullptr) {
+                auto* blocks = shared_free_lists.take_all(size_class);
+                if (blocks == nullptr) return new_block((size_class + 1) * POOL_BLOCK_SIZE);
+
+                local.heads[size_class] = blocks;
+                for (; blocks != nullptr; blocks = blocks->next) ++local.counts[size_class];
+            }
+
+            --local.counts[size_class];
+            return std::exchange(local.heads[size_class], local.heads[size_class]->next);
+        }
+
+        /////////////////////////////////////
+        /////////////////////////////////////
+        auto pool_deallocate(void* ptr, usize size) noexcept -> void {
+            if (size > POOL_MAX_BLOCK_SIZE) [[unlikely]] {
+                delete_block(ptr);
+                return;
+            }
+
+            const auto size_class = size_class_of(size);
+            auto&      local      = local_free_lists;
+
+            local.heads[size_class] = std::construct_at(static_cast<FreeBlock*>(ptr),
+                                                        local.heads[size_class]);
+            if (++local.counts[size_class] > 2 * LOCAL_CACHE_SIZE)
+                local.spill(size_class, LOCAL_CACHE_SIZE);
+        }
+    } // namespace details
+
+    /////////////////////////////////////
+    /////////////////////////////////////
+    FrameArena::FrameArena(usize capacity, std::pmr::memory_resource* upstream)
+        : m_upstream { upstream } {
+        EXPECTS(capacity > 0);
+        EXPECTS(m_upstream != nullptr);
+
+        add_chunk(capacity);
+    }
+
+    /////////////////////////////////////
+    /////////////////////////////////////
+    FrameArena::~FrameArena() noexcept {
+        release_chunks();
+    }
+
+    /////////////////////////////////////
+    /////////////////////////////////////
+    auto FrameArena::reset() -> void {
+        if (std::size(m_chunks) == 1) {
+            m_current       = m_chunks.front().data;
+            m_previous_used = 0;
+            return;
+        }
+
+        const auto total = capacity();
+        release_chunks();
+        add_chunk(total);
+    }
+
+    /////////////////////////////////////
+    /////////////////////////////////////
+    auto FrameArena::used() const noexcept -> usize {
+        return m_previous_used + as<usize>(m_current - m_chunks.back().data);
+    }
+
+    /////////////////////////////////////
+    /////////////////////////////////////
+    auto FrameArena::capacity() const noexcept -> usize {
+        return std::ranges::fold_left(m_chunks, usize { 0 }, [](auto acc, const auto& chunk) {
+            return acc + chunk.size;
+        });
+    }
+
+    /////////////////////////////////////
+    /////////////////////////////////////
+    auto FrameArena::do_allocate(usize size, usize alignment) -> void* {
+        auto* ptr = align_up(m_current, alignment);
+        if (ptr > m_end or as<usize>(m_end - ptr) < size) [[unlikely]] {
+            // geometric growth, reset() merge the chunks so it only happen on new peaks
+            add_chunk(std::max(m_chunks.back().size * 2, size + alignment));
+            ptr = align_up(m_current, alignment);
+        }
+
+        m_current = ptr + size;
+
+        return ptr;
+    }
+
+    /////////////////////////////////////
+    /////////////////////////////////////
+    auto FrameArena::do_deallocate(void*, usize, usize) -> void {
+    }
+
+    /////////////////////////////////////
+    /////////////////////////////////////
+    auto FrameArena::do_is_equal(const std::pmr::memory_resource& other) const noexcept -> bool {
+        return this == &other;
+    }
+
+    /////////////////////////////////////
+    /////////////////////////////////////
+    auto FrameArena::add_chunk(usize size) -> void {
+        m_chunks.reserve(std::size(m_chunks) + 1);
+
+        auto* data = static_cast<std::byte*>(m_upstream->allocate(size, alignof(std::max_align_t)));
+        if (not std::empty(m_chunks)) m_previous_used += as<usize>(m_current - m_chunks.back().data);
+
+        m_chunks.emplace_back(data, size);
+        m_current = data;
+        m_end     = data + size;
+    }
+
+    /////////////////////////////////////
+    /////////////////////////////////////
+    auto FrameArena::release_chunks() noexcept -> void {
+        for (const auto& chunk : m_chunks)
+            m_upstream->deallocate(chunk.data, chunk.size, alignof(std::max_align_t));
+
+        m_chunks.clear();
+        m_current       = nullptr;
+        m_end           = nullptr;
+        m_previous_used = 0;
+    }
+
+    /////////////////////////////////////
+    /////////////////////////////////////
+    PoolResource::PoolResource(std::pmr::memory_resource* upstream) noexcept
+        : m_upstream { upstream } {
+        EXPECTS(m_upstream != nullptr);
+    }
+
+    /////////////////////////////////////
+    /////////////////////////////////////
+    PoolResource::~PoolResource() noexcept = default;
+
+    /////////////////////////////////////
+    /////////////////////////////////////
+    auto PoolResource::do_allocate(usize size, usize alignment) -> void* {
+        if (size > details::POOL_MAX_BLOCK_SIZE or alignment > details::POOL_BLOCK_SIZE)
+            return m_upstream->allocate(size, alignment);
+
+        return details::pool_allocate(std::max(size, usize { 1 }));
+    }
+
+    /////////////////////////////////////
+    /////////////////////////////////////
+    auto PoolResource::do_deallocate(void* ptr, usize size, usize alignment) -> void {
+        if (size > details::POOL_MAX_BLOCK_SIZE or alignment > details::POOL_BLOCK_SIZE) {
+            m_upstream->deallocate(ptr, size, alignment);
+            return;
+        }
+
+        details::pool_deallocate(ptr, std::max(size, usize { 1 }));
+    }
+
+    /////////////////////////////////////
+    /////////////////////////////////////
+    auto PoolResource::do_is_equal(const std::pmr::memory_resource& other) const noexcept
+      -> bool {
+        return this == &other;
+    }
+
+    /////////////////////////////////////
+    /////////////////////////////////////
+    auto pool_resource() noexcept -> PoolResource& {
+        static auto resource = PoolResource { std::pmr::new_delete_resource() };
+
+        return resource;
+    }
+
+    /// Every block start with this header, the payload follow it. `prev_physical` is always
+    /// valid so a freed block can be merged with both neighbours in O(1), the end of a pool is
+    /// marked with a used sentinel block of size 0
+    struct alignas(usize { 1 } << TlsfResource::ALIGN_LOG2) TlsfResource::Block {
+        static constexpr auto FREE_BIT = usize { 1 };
+
+        /// Links of the segregated free-lists, stored in the payload of free blocks
+        struct FreeLinks {
+            Block* next;
+            Block* prev;
+        };
+
+        static constexpr auto HEADER_SIZE = usize { 1 } << ALIGN_LOG2;
+        static constexpr auto MIN_SIZE    = align_up(sizeof(FreeLinks), HEADER_SIZE);
+        /// Smallest piece worth splitting off a block
+        static constexpr auto MIN_SPLIT = HEADER_SIZE + MIN_SIZE;
+
+        static auto make(std::byte* at, Block* prev_physical, usize size, bool free) noexcept
+          -> Block* {
+            return std::construct_at(reinterpret_cast<Block*>(at),
+                                     prev_physical,
+                                     size | (free ? FREE_BIT : 0));
+        }
+
+        static auto from_payload(void* ptr) noexcept -> Block* {
+            return reinterpret_cast<Block*>(static_cast<std::byte*>(ptr) - HEADER_SIZE);
+        }
+
+        auto size() const noexcept -> usize { return size_and_flags & ~FREE_BIT; }
+
+        auto set_size(usize size) noexcept -> void {
+            size_and_flags = size | (size_and_flags & FREE_BIT);
+        }
+
+        auto is_free() const noexcept -> bool { return (size_and_flags & FREE_BIT) != 0; }
+
+        auto set_free(bool free) noexcept -> void {
+            size_and_flags = size() | (free ? FREE_BIT : 0);
+        }
+
+        auto payload() noexcept -> std::byte* {
+            return reinterpret_cast<std::byte*>(this) + HEADER_SIZE;
+        }
+
+        auto links() noexcept -> FreeLinks* {
+            return std::launder(reinterpret_cast<FreeLinks*>(payload()));
+        }
+
+        auto next_physical() noexcept -> Block* {
+            return reinterpret_cast<Block*>(payload() + size());
+        }
+
+        Block* prev_physical;
+        usize  size_and_flags;
+    };
+
+    /////////////////////////////////////
+    /////////////////////////////////////
+    TlsfResource::TlsfResource(usize pool_size, std::pmr::memory_resource* upstream)
+        : m_upstream { upstream }, m_pool_size { pool_size } {
+        EXPECTS(m_upstream != nullptr);
+        EXPECTS(m_pool_size > 0);
+    }
+
+    /////////////////////////////////////
+    /////////////////////////////////////
+    TlsfResource::~TlsfResource() noexcept {
+        for (const auto& [data, size] : m_pools)
+            m_upstream->deallocate(data, size, Block::HEADER_SIZE);
+    }
+
+    /////////////////////////////////////
+    /////////////////////////////////////
+    auto TlsfResource::do_allocate(usize bytes, usize alignment) -> void* {
+        EXPECTS(std::has_single_bit(alignment));
+
+        // the first level index must stay in the bitmap
+        static constexpr auto MAX_SIZE = usize { 1 } << (FL_COUNT + FL_SHIFT - 2);
+        if (bytes > MAX_SIZE) [[unlikely]]
+            throw std::bad_alloc {};
+
+        const auto size = std::max(align_up(bytes, Block::HEADER_SIZE), Block::MIN_SIZE);
+        // room to move the payload forward and split the gap off as a free block
+        const auto extra   = (alignment > Block::HEADER_SIZE) ? alignment + Block::MIN_SPLIT : 0;
+        const auto request = size + extra;
+
+        auto* block = find_free(request);
+        if (block == nullptr) {
+            // enough for the rounded up size class find_free look in
+            add_pool(std::max(m_pool_size, request + (request >> SL_LOG2) + Block::HEADER_SIZE));
+            block = find_free(request);
+        }
+        ENSURES(block != nullptr);
+
+        remove(block);
+
+        if (extra > 0) {
+            auto* payload = block->payload();
+            auto* aligned = align_up(payload, alignment);
+            if (aligned != payload and as<usize>(aligned - payload) < Block::MIN_SPLIT)
+                aligned = align_up(payload + Block::MIN_SPLIT, alignment);
+
+            if (const auto gap = as<usize>(aligned - payload); gap > 0) {
+                // the previous physical block is used (free neighbours are always merged), so
+                // the front piece can go back in the free-lists as is
+                auto* front = block;
+                block       = Block::make(aligned - Block::HEADER_SIZE,
+                                    front,
+                                    front->size() - gap,
+                                    false);
+                block->next_physical()->prev_physical = block;
+
+                front->set_size(gap - Block::HEADER_SIZE);
+                insert(front);
+            }
+        }
+
+        if (block->size() >= size + Block::MIN_SPLIT) {
+            auto* rest = Block::make(block->payload() + size,
+                                     block,
+                                     block->size() - size - Block::HEADER_SIZE,
+                                     true);
+            rest->next_physical()->prev_physical = rest;
+            block->set_size(size);
+
+            insert(rest);
+        }
+
+        block->set_free(false);
+
+        return block->payload();
+    }
+
+    /////////////////////////////////////
+    /////////////////////////////////////
+    auto TlsfResource::do_deallocate(void* ptr, usize, usize) -> void {
+        auto* block = Block::from_payload(ptr);
+        block->set_free(true);
+
+        if (auto* prev = block->prev_physical; prev != nullptr and prev->is_free()) {
+            remove(prev);
+            prev->set_size(prev->size() + Block::HEADER_SIZE + block->size());
+            block = prev;
+            block->next_physical()->prev_physical = block;
+        }
+
+        if (auto* next = block->next_physical(); next->is_free()) {
+            remove(next);
+            block->set_size(block->size() + Block::HEADER_SIZE + next->size());
+            block->next_physical()->prev_physical = block;
+        }
+
+        insert(block);
+    }
+
+    /////////////////////////////////////
+    /////////////////////////////////////
+    auto TlsfResource::do_is_equal(const std::pmr::memory_resource& other) const noexcept
+      -> bool {
+        return this == &other;
+    }
+
+    /////////////////////////////////////
+    /////////////////////////////////////
+    auto TlsfResource::add_pool(usize size) -> void {
+        const auto payload_size = align_up(size, Block::HEADER_SIZE);
+        // one header for the block, one for the end sentinel
+        const auto total = payload_size + 2 * Block::HEADER_SIZE;
+
+        m_pools.reserve(std::size(m_pools) + 1);
+        auto* data = static_cast<std::byte*>(m_upstream->allocate(total, Block::HEADER_SIZE));
+        m_pools.emplace_back(data, total);
+
+        auto* block = Block::make(data, nullptr, payload_size, true);
+        Block::make(block->payload() + payload_size, block, 0, false);
+
+        insert(block);
+    }
+
+    namespace {
+        /////////////////////////////////////
+        /////////////////////////////////////
+        template<u32 ALIGN_LOG2, u32 SL_LOG2>
+        constexpr auto tlsf_mapping(usize size) noexcept -> std::pair<u32, u32> {
+            constexpr auto FL_SHIFT = SL_LOG2 + ALIGN_LOG2;
+
+            if (size < (usize { 1 } << FL_SHIFT)) return { 0u, as<u32>(size >> ALIGN_LOG2) };
+
+            const auto msb = as<u32>(std::bit_width(size) - 1);
+            const auto sl  = as<u32>(size >> (msb - SL_LOG2)) ^ (1u << SL_LOG2);
+
+            return { msb - FL_SHIFT + 1, sl };
+        }
+    } // namespace
+
+    /////////////////////////////////////
+    /////////////////////////////////////
+    auto TlsfResource::find_free(usize size) noexcept -> Block* {
+        // round up to the next size class so any block of the class found is big enough
+        if (size >= SMALL_SIZE) size += (usize { 1 } << (std::bit_width(size) - 1 - SL_LOG2)) - 1;
+
+        auto [fl, sl] = tlsf_mapping<ALIGN_LOG2, SL_LOG2>(size);
+        if (fl >= FL_COUNT) return nullptr;
+
+        auto sl_map = m_sl_bitmaps[fl] & (~0u << sl);
+        if (sl_map == 0) {
+            const auto fl_map = (fl + 1 < FL_COUNT) ? m_fl_bitmap & (~0u << (fl + 1)) : 0u;
+            if (fl_map == 0) return nullptr;
+
+            fl     = as<u32>(std::countr_zero(fl_map));
+            sl_map = m_sl_bitmaps[fl];
+        }
+        sl = as<u32>(std::countr_zero(sl_map));
+
+        return m_free[fl][sl];
+    }
+
+    /////////////////////////////////////
+    /////////////////////////////////////
+    auto TlsfResource::insert(Block* block) noexcept -> void {
+        const auto [fl, sl] = tlsf_mapping<ALIGN_LOG2, SL_LOG2>(block->size());
+        auto& head          = m_free[fl][sl];
+
+        std::construct_at(reinterpret_cast<Block::FreeLinks*>(block->payload()),
+                          head,
+                          static_cast<Block*>(nullptr));
+        if (head != nullptr) head->links()->prev = block;
+        head = block;
+
+        m_sl_bitmaps[fl] |= 1u << sl;
+        m_fl_bitmap      |= 1u << fl;
+    }
+
+    /////////////////////////////////////
+    /////////////////////////////////////
+    auto TlsfResource::remove(Block* block) noexcept -> void {
+        const auto [fl, sl] = tlsf_mapping<ALIGN_LOG2, SL_LOG2>(block->size());
+        auto* links         = block->links();
+
+        if (links->prev != nullptr) links->prev->links()->next = links->next;
+        else
+            m_free[fl][sl] = links->next;
+        if (links->next != nullptr) links->next->links()->prev = links->prev;
+
+        if (m_free[fl][sl] == nullptr) {
+            m_sl_bitmaps[fl] &= ~(1u << sl);
+            if (m_sl_bitmaps[fl] == 0) m_fl_bitmap &= ~(1u << fl);
+        }
+    }
+} // namespace stormkit
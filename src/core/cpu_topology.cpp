@@ -0,0 +1,50 @@
+// Copyright (C) 2024 Arthur LAURENT <arthur.laurent4@gmail.com>
+// This file is subject to the license terms in the LICENSE file
+// found in the top-level of this distribution
+
+module stormkit.core;
+
+import std;
+
+namespace stormkit { inline namespace core {
+    namespace details {
+        ////////////////////////////////////////
+        ////////////////////////////////////////
+        auto make_flat_cpu_topology() noexcept -> CpuTopology {
+            const auto count = std::max(std::thread::hardware_concurrency(), 1u);
+
+            auto topology       = CpuTopology {};
+            topology.core_count = count;
+            topology.cpus.reserve(count);
+            for (const auto i : range(count))
+                topology.cpus.emplace_back(
+                  LogicalCpu { .id = i, .core = i, .package = 0, .numa_node = 0, .l3_group = 0 });
+
+            return topology;
+        }
+    } // namespace details
+
+    ////////////////////////////////////////
+    ////////////////////////////////////////
+    auto CpuTopology::physical_cores(std::optional<u32> numa_node) const
+      -> std::vector<std::vector<u32>> {
+        auto cores = std::vector<std::vector<u32>>(core_count);
+        for (const auto& cpu : cpus) {
+            if (numa_node and cpu.numa_node != *numa_node) continue;
+
+            cores[cpu.core].emplace_back(cpu.id);
+        }
+
+        std::erase_if(cores, [](const auto& core) static noexcept { return std::empty(core); });
+
+        return cores;
+    }
+
+    ////////////////////////////////////////
+    ////////////////////////////////////////
+    auto cpu_topology() noexcept -> const CpuTopology& {
+        static const auto topology = details::discover_cpu_topology();
+
+        return topology;
+    }
+}} // namespace stormkit::core
@@ -1,5 +1,8 @@
 module;
 
+#include <pthread.h>
+#include <pthread/qos.h>
+
 extern "C" {
 #include "threadutils_impl.h"
 }
@@ -11,6 +14,51 @@ import std;
 import :parallelism.threadutils;
 
 namespace stormkit { inline namespace core {
+    namespace details {
+        ////////////////////////////////////////
+        ////////////////////////////////////////
+        auto discover_cpu_topology() noexcept -> CpuTopology {
+            return make_flat_cpu_topology();
+        }
+    } // namespace details
+
+    ////////////////////////////////////////
+    ////////////////////////////////////////
+    auto set_current_thread_affinity(std::span<const u32>) noexcept
+      -> std::expected<void, std::error_code> {
+        // macOS only exposes affinity hints through the thread_policy API, not hard pinning
+        return std::unexpected(std::make_error_code(std::errc::not_supported));
+    }
+
+    ////////////////////////////////////////
+    ////////////////////////////////////////
+    auto set_thread_affinity(std::thread&, std::span<const u32>) noexcept
+      -> std::expected<void, std::error_code> {
+        return std::unexpected(std::make_error_code(std::errc::not_supported));
+    }
+
+    ////////////////////////////////////////
+    ////////////////////////////////////////
+    auto set_current_thread_priority(ThreadPriority priority) noexcept
+      -> std::expected<void, std::error_code> {
+        const auto qos = [priority] noexcept {
+            switch (priority) {
+                case ThreadPriority::Idle: return QOS_CLASS_BACKGROUND;
+                case ThreadPriority::Low: return QOS_CLASS_UTILITY;
+                case ThreadPriority::Normal: return QOS_CLASS_DEFAULT;
+                case ThreadPriority::High: return QOS_CLASS_USER_INITIATED;
+                case ThreadPriority::Highest: return QOS_CLASS_USER_INTERACTIVE;
+            }
+            std::unreachable();
+        }();
+
+        const auto result = pthread_set_qos_class_self_np(qos, 0);
+        if (result != 0)
+            return std::unexpected(std::error_code { result, std::system_category() });
+
+        return {};
+    }
+
     ////////////////////////////////////////
     ////////////////////////////////////////
     auto set_current_thread_name(std::string_view name) noexcept -> void {
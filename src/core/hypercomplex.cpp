@@ -0,0 +1,271 @@
+// Copyright (C) 2024 Arthur LAURENT <arthur.laurent4@gmail.com>
+// This file is subject to the license terms in the LICENSE file
+// found in the top-level of this distribution
+
+module;
+
+#include <stormkit/core/contract_macro.hpp>
+#include <stormkit/core/platform_macro.hpp>
+#include <stormkit/core/simd_macro.hpp>
+
+module stormkit.core;
+
+import std;
+
+namespace stormkit { inline namespace core { namespace math {
+    namespace {
+#if defined(STORMKIT_SIMD)
+        using namespace simd::details;
+
+        /// 4 quaternions in structure of arrays form
+        struct QuatLanes {
+            f32x4 x;
+            f32x4 y;
+            f32x4 z;
+            f32x4 w;
+        };
+
+        ////////////////////////////////////////
+        ////////////////////////////////////////
+        STORMKIT_FORCE_INLINE
+        inline auto load_lanes(const quatf* values) noexcept -> QuatLanes {
+            auto lanes = QuatLanes { load(&values[0].x),
+                                     load(&values[1].x),
+                                     load(&values[2].x),
+                                     load(&values[3].x) };
+            transpose(lanes.x, lanes.y, lanes.z, lanes.w);
+
+            return lanes;
+        }
+
+        ////////////////////////////////////////
+        ////////////////////////////////////////
+        STORMKIT_FORCE_INLINE
+        inline auto store_lanes(quatf* values, QuatLanes lanes) noexcept -> void {
+            transpose(lanes.x, lanes.y, lanes.z, lanes.w);
+
+            store(&values[0].x, lanes.x);
+            store(&values[1].x, lanes.y);
+            store(&values[2].x, lanes.z);
+            store(&values[3].x, lanes.w);
+        }
+
+        ////////////////////////////////////////
+        ////////////////////////////////////////
+        STORMKIT_FORCE_INLINE
+        inline auto store_rows(mat4x4f& matrix,
+                               f32x4    row0,
+                               f32x4    row1,
+                               f32x4    row2,
+                               f32x4    row3) noexcept -> void {
+            auto* data = matrix.data();
+            store(data, row0);
+            store(data + 4, row1);
+            store(data + 8, row2);
+            store(data + 12, row3);
+        }
+
+        ////////////////////////////////////////
+        ////////////////////////////////////////
+        STORMKIT_FORCE_INLINE
+        inline auto lanes_dot(const QuatLanes& a, const QuatLanes& b) noexcept -> f32x4 {
+            return fmadd(a.x, b.x, fmadd(a.y, b.y, fmadd(a.z, b.z, mul(a.w, b.w))));
+        }
+
+        ////////////////////////////////////////
+        ////////////////////////////////////////
+        STORMKIT_FORCE_INLINE
+        inline auto lanes_normalize(const QuatLanes& value, Precision precision) noexcept
+          -> QuatLanes {
+            const auto length2 = lanes_dot(value, value);
+            const auto factor  = (precision == Precision::Fast) ? rsqrt(length2)
+                                                                 : div(splat(1.f), sqrt(length2));
+
+            return { mul(value.x, factor),
+                     mul(value.y, factor),
+                     mul(value.z, factor),
+                     mul(value.w, factor) };
+        }
+
+        ////////////////////////////////////////
+        ////////////////////////////////////////
+        /// normalize(a + (b - a) * t) with b flipped to the same hemisphere as a
+        STORMKIT_FORCE_INLINE
+        inline auto lanes_nlerp(const QuatLanes& a,
+                                const QuatLanes& b,
+                                f32x4            cos,
+                                f32x4            t,
+                                Precision        precision) noexcept -> QuatLanes {
+            const auto lerp = [&cos, &t](f32x4 from, f32x4 to) noexcept {
+                return fmadd(sub(flip_sign(to, cos), from), t, from);
+            };
+
+            const auto lanes = QuatLanes {
+                lerp(a.x, b.x),
+                lerp(a.y, b.y),
+                lerp(a.z, b.z),
+                lerp(a.w, b.w),
+            };
+
+            return lanes_normalize(lanes, precision);
+        }
+
+        ////////////////////////////////////////
+        ////////////////////////////////////////
+        /// SIMD version of details::slerp_fit
+        STORMKIT_FORCE_INLINE
+        inline auto lanes_slerp_fit(f32x4 cos, f32x4 t) noexcept -> f32x4 {
+            using details::SLERP_FIT_A;
+            using details::SLERP_FIT_B;
+
+            const auto d = abs(cos);
+            const auto a = fmadd(d,
+                                 fmadd(d,
+                                       fmadd(d, splat(SLERP_FIT_A[3]), splat(SLERP_FIT_A[2])),
+                                       splat(SLERP_FIT_A[1])),
+                                 splat(SLERP_FIT_A[0]));
+            const auto b = fmadd(d,
+                                 fmadd(d, splat(SLERP_FIT_B[2]), splat(SLERP_FIT_B[1])),
+                                 splat(SLERP_FIT_B[0]));
+
+            const auto centered = sub(t, splat(0.5f));
+            const auto k        = fmadd(mul(a, centered), centered, b);
+            return fmadd(mul(mul(t, centered), sub(t, splat(1.f))), k, t);
+        }
+#endif
+    } // namespace
+
+    ////////////////////////////////////////
+    ////////////////////////////////////////
+    auto normalize_batch(std::span<const quatf> values,
+                         std::span<quatf>       out,
+                         Precision              precision) noexcept -> void {
+        EXPECTS(std::size(values) == std::size(out));
+
+        auto i = 0uz;
+#if defined(STORMKIT_SIMD)
+        for (; i + 4 <= std::size(values); i += 4)
+            store_lanes(&out[i], lanes_normalize(load_lanes(&values[i]), precision));
+#endif
+
+        for (; i < std::size(values); ++i)
+            out[i] = (precision == Precision::Fast) ? normalize<Precision::Fast>(values[i])
+                                                    : normalize(values[i]);
+    }
+
+    ////////////////////////////////////////
+    ////////////////////////////////////////
+    auto nlerp_batch(std::span<const quatf> a,
+                     std::span<const quatf> b,
+                     std::span<const f32>   t,
+                     std::span<quatf>       out,
+                     Precision              precision) noexcept -> void {
+        EXPECTS(std::size(a) == std::size(b));
+        EXPECTS(std::size(a) == std::size(t));
+        EXPECTS(std::size(a) == std::size(out));
+
+        auto i = 0uz;
+#if defined(STORMKIT_SIMD)
+        for (; i + 4 <= std::size(a); i += 4) {
+            const auto from = load_lanes(&a[i]);
+            const auto to   = load_lanes(&b[i]);
+
+            store_lanes(&out[i],
+                        lanes_nlerp(from, to, lanes_dot(from, to), load(&t[i]), precision));
+        }
+#endif
+
+        for (; i < std::size(a); ++i)
+            out[i] = (precision == Precision::Fast) ? nlerp<Precision::Fast>(a[i], b[i], t[i])
+                                                    : nlerp(a[i], b[i], t[i]);
+    }
+
+    ////////////////////////////////////////
+    ////////////////////////////////////////
+    auto slerp_batch(std::span<const quatf> a,
+                     std::span<const quatf> b,
+                     std::span<const f32>   t,
+                     std::span<quatf>       out,
+                     Precision              precision) noexcept -> void {
+        EXPECTS(std::size(a) == std::size(b));
+        EXPECTS(std::size(a) == std::size(t));
+        EXPECTS(std::size(a) == std::size(out));
+
+        if (precision == Precision::Exact) {
+            for (auto i = 0uz; i < std::size(a); ++i) out[i] = slerp(a[i], b[i], t[i]);
+            return;
+        }
+
+        auto i = 0uz;
+#if defined(STORMKIT_SIMD)
+        for (; i + 4 <= std::size(a); i += 4) {
+            const auto from = load_lanes(&a[i]);
+            const auto to   = load_lanes(&b[i]);
+            const auto cos  = lanes_dot(from, to);
+
+            store_lanes(&out[i],
+                        lanes_nlerp(from,
+                                    to,
+                                    cos,
+                                    lanes_slerp_fit(cos, load(&t[i])),
+                                    Precision::Fast));
+        }
+#endif
+
+        for (; i < std::size(a); ++i) out[i] = slerp<Precision::Fast>(a[i], b[i], t[i]);
+    }
+
+    ////////////////////////////////////////
+    ////////////////////////////////////////
+    auto to_mat4x4_batch(std::span<const quatf> values, std::span<mat4x4f> out) noexcept -> void {
+        EXPECTS(std::size(values) == std::size(out));
+
+        auto i = 0uz;
+#if defined(STORMKIT_SIMD)
+        const auto one      = splat(1.f);
+        const auto two      = splat(2.f);
+        const auto last_row = set(0.f, 0.f, 0.f, 1.f);
+
+        for (; i + 4 <= std::size(values); i += 4) {
+            const auto [x, y, z, w] = load_lanes(&values[i]);
+
+            const auto xx = mul(x, x);
+            const auto yy = mul(y, y);
+            const auto zz = mul(z, z);
+            const auto xy = mul(x, y);
+            const auto xz = mul(x, z);
+            const auto yz = mul(y, z);
+            const auto wx = mul(w, x);
+            const auto wy = mul(w, y);
+            const auto wz = mul(w, z);
+
+            // element (row, column) of the 4 matrices, same formulas as to_mat4x4
+            auto m00 = sub(one, mul(two, add(yy, zz)));
+            auto m01 = mul(two, add(xy, wz));
+            auto m02 = mul(two, sub(xz, wy));
+            auto m10 = mul(two, sub(xy, wz));
+            auto m11 = sub(one, mul(two, add(xx, zz)));
+            auto m12 = mul(two, add(yz, wx));
+            auto m20 = mul(two, add(xz, wy));
+            auto m21 = mul(two, sub(yz, wx));
+            auto m22 = sub(one, mul(two, add(xx, yy)));
+
+            // transposing turns the lanes of each row into the rows of the 4 matrices
+            auto zero0 = splat(0.f);
+            auto zero1 = splat(0.f);
+            auto zero2 = splat(0.f);
+            transpose(m00, m01, m02, zero0);
+            transpose(m10, m11, m12, zero1);
+            transpose(m20, m21, m22, zero2);
+
+            // stored directly, f32x4 can't be put in std::array without losing its attributes
+            store_rows(out[i], m00, m10, m20, last_row);
+            store_rows(out[i + 1], m01, m11, m21, last_row);
+            store_rows(out[i + 2], m02, m12, m22, last_row);
+            store_rows(out[i + 3], zero0, zero1, zero2, last_row);
+        }
+#endif
+
+        for (; i < std::size(values); ++i) out[i] = to_mat4x4(values[i]);
+    }
+}}} // namespace stormkit::core::math
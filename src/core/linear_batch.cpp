@@ -0,0 +1,329 @@
+// Copyright (C) 2024 Arthur LAURENT <arthur.laurent4@gmail.com>
+// This file is subject to the license terms in the LICENSE file
+// found in the top-level of this distribution
+
+module;
+
+#include <stormkit/core/contract_macro.hpp>
+#include <stormkit/core/platform_macro.hpp>
+#include <stormkit/core/simd_macro.hpp>
+
+module stormkit.core;
+
+import std;
+
+namespace stormkit { inline namespace core { namespace math {
+    namespace {
+        ////////////////////////////////////////
+        ////////////////////////////////////////
+        STORMKIT_FORCE_INLINE
+        inline auto transform_point(const vec3f& point, const mat4x4f& mat) noexcept -> vec3f {
+            return {
+                point.x * mat[0, 0] + point.y * mat[1, 0] + point.z * mat[2, 0] + mat[3, 0],
+                point.x * mat[0, 1] + point.y * mat[1, 1] + point.z * mat[2, 1] + mat[3, 1],
+                point.x * mat[0, 2] + point.y * mat[1, 2] + point.z * mat[2, 2] + mat[3, 2],
+            };
+        }
+
+#if defined(STORMKIT_SIMD)
+        using namespace simd::details;
+
+        /// The first three columns of a matrix with each coefficient broadcasted in a register,
+        /// to transform 4 (or 8) points stored as x, y and z registers. C arrays as std::array
+        /// would drop the vector type attributes
+        struct Columns {
+            f32x4 coefficients[12];
+        };
+
+        ////////////////////////////////////////
+        ////////////////////////////////////////
+        STORMKIT_FORCE_INLINE
+        inline auto make_columns(const mat4x4f& mat) noexcept -> Columns {
+            auto columns = Columns {};
+            for (auto i = 0u; i < 4; ++i)
+                for (auto j = 0u; j < 3; ++j) columns.coefficients[i * 3 + j] = splat(mat[i, j]);
+
+            return columns;
+        }
+
+        ////////////////////////////////////////
+        ////////////////////////////////////////
+        STORMKIT_FORCE_INLINE
+        inline auto transform(const Columns& columns, f32x4& x, f32x4& y, f32x4& z) noexcept
+          -> void {
+            const auto& c = columns.coefficients;
+
+            const auto out_x = fmadd(x, c[0], fmadd(y, c[3], fmadd(z, c[6], c[9])));
+            const auto out_y = fmadd(x, c[1], fmadd(y, c[4], fmadd(z, c[7], c[10])));
+            const auto out_z = fmadd(x, c[2], fmadd(y, c[5], fmadd(z, c[8], c[11])));
+
+            x = out_x;
+            y = out_y;
+            z = out_z;
+        }
+
+        ////////////////////////////////////////
+        ////////////////////////////////////////
+        /// Deinterleave 4 contiguous vec3 in x, y and z registers
+        STORMKIT_FORCE_INLINE
+        inline auto load_points(const f32* data, f32x4& x, f32x4& y, f32x4& z) noexcept -> void {
+    #if defined(STORMKIT_SIMD_NEON)
+            const auto points = vld3q_f32(data);
+            x                 = points.val[0];
+            y                 = points.val[1];
+            z                 = points.val[2];
+    #else
+            // a = x0 y0 z0 x1, b = y1 z1 x2 y2, c = z2 x3 y3 z3
+            const auto a = load(data);
+            const auto b = load(data + 4);
+            const auto c = load(data + 8);
+
+            const auto y0z0y1z1 = shuffle<1, 2, 0, 1>(a, b);
+
+            x = shuffle<0, 3, 0, 3>(a, shuffle<2, 3, 0, 1>(b, c));
+            y = shuffle<0, 2, 0, 2>(y0z0y1z1, shuffle<3, 0, 2, 0>(b, c));
+            z = shuffle<1, 3, 0, 3>(y0z0y1z1, c);
+    #endif
+        }
+
+        ////////////////////////////////////////
+        ////////////////////////////////////////
+        /// Interleave x, y and z registers back in 4 contiguous vec3
+        STORMKIT_FORCE_INLINE
+        inline auto store_points(f32* data, f32x4 x, f32x4 y, f32x4 z) noexcept -> void {
+    #if defined(STORMKIT_SIMD_NEON)
+            vst3q_f32(data, float32x4x3_t { { x, y, z } });
+    #else
+            store(data, shuffle<0, 2, 0, 2>(shuffle<0, 1, 0, 1>(x, y), shuffle<0, 0, 1, 1>(z, x)));
+            store(data + 4,
+                  shuffle<0, 2, 0, 2>(shuffle<1, 1, 1, 1>(y, z), shuffle<2, 2, 2, 2>(x, y)));
+            store(data + 8,
+                  shuffle<0, 2, 0, 2>(shuffle<2, 2, 3, 3>(z, x), shuffle<3, 3, 3, 3>(y, z)));
+    #endif
+        }
+
+    #if defined(STORMKIT_SIMD_AVX2)
+        struct WideColumns {
+            __m256 coefficients[12];
+        };
+
+        ////////////////////////////////////////
+        ////////////////////////////////////////
+        STORMKIT_FORCE_INLINE
+        inline auto make_wide_columns(const mat4x4f& mat) noexcept -> WideColumns {
+            auto columns = WideColumns {};
+            for (auto i = 0u; i < 4; ++i)
+                for (auto j = 0u; j < 3; ++j)
+                    columns.coefficients[i * 3 + j] = _mm256_set1_ps(mat[i, j]);
+
+            return columns;
+        }
+
+        ////////////////////////////////////////
+        ////////////////////////////////////////
+        STORMKIT_FORCE_INLINE
+        inline auto transform(const WideColumns& columns,
+                              __m256&            x,
+                              __m256&            y,
+                              __m256&            z) noexcept -> void {
+            const auto& c = columns.coefficients;
+
+            const auto out_x = fmadd(x, c[0], fmadd(y, c[3], fmadd(z, c[6], c[9])));
+            const auto out_y = fmadd(x, c[1], fmadd(y, c[4], fmadd(z, c[7], c[10])));
+            const auto out_z = fmadd(x, c[2], fmadd(y, c[5], fmadd(z, c[8], c[11])));
+
+            x = out_x;
+            y = out_y;
+            z = out_z;
+        }
+    #endif
+#endif
+    } // namespace
+
+    ////////////////////////////////////////
+    ////////////////////////////////////////
+    auto to_aosoa(std::span<const vec3f> values, std::span<vec3x8f> out) noexcept -> void {
+        EXPECTS(std::size(out) == aosoa_block_count(std::size(values)));
+
+        for (auto i = 0uz; i < std::size(out); ++i) {
+            const auto first = i * vec3x8f::WIDTH;
+            const auto count = std::min(vec3x8f::WIDTH, std::size(values) - first);
+
+            auto& block = out[i];
+            block       = {};
+            for (auto lane = 0uz; lane < count; ++lane) {
+                const auto& value = values[first + lane];
+                block.x[lane]     = value.x;
+                block.y[lane]     = value.y;
+                block.z[lane]     = value.z;
+            }
+        }
+    }
+
+    ////////////////////////////////////////
+    ////////////////////////////////////////
+    auto from_aosoa(std::span<const vec3x8f> values, std::span<vec3f> out) noexcept -> void {
+        EXPECTS(std::size(values) == aosoa_block_count(std::size(out)));
+
+        for (auto i = 0uz; i < std::size(out); ++i) {
+            const auto& block = values[i / vec3x8f::WIDTH];
+            const auto  lane  = i % vec3x8f::WIDTH;
+            out[i]            = { block.x[lane], block.y[lane], block.z[lane] };
+        }
+    }
+
+    ////////////////////////////////////////
+    ////////////////////////////////////////
+    auto transform_points(std::span<const vec3f> points,
+                          const mat4x4f&         mat,
+                          std::span<vec3f>       out) noexcept -> void {
+        EXPECTS(std::size(points) == std::size(out));
+
+        auto i = 0uz;
+#if defined(STORMKIT_SIMD)
+        const auto columns = make_columns(mat);
+        for (; i + 4 <= std::size(points); i += 4) {
+            auto x = f32x4 {};
+            auto y = f32x4 {};
+            auto z = f32x4 {};
+            load_points(&points[i].x, x, y, z);
+            transform(columns, x, y, z);
+            store_points(&out[i].x, x, y, z);
+        }
+#endif
+
+        for (; i < std::size(points); ++i) out[i] = transform_point(points[i], mat);
+    }
+
+    ////////////////////////////////////////
+    ////////////////////////////////////////
+    auto transform_points(std::span<const vec3x8f> points,
+                          const mat4x4f&           mat,
+                          std::span<vec3x8f>       out) noexcept -> void {
+        EXPECTS(std::size(points) == std::size(out));
+
+#if defined(STORMKIT_SIMD_AVX2)
+        const auto columns = make_wide_columns(mat);
+        for (auto i = 0uz; i < std::size(points); ++i) {
+            auto x = _mm256_load_ps(points[i].x.data());
+            auto y = _mm256_load_ps(points[i].y.data());
+            auto z = _mm256_load_ps(points[i].z.data());
+            transform(columns, x, y, z);
+            _mm256_store_ps(out[i].x.data(), x);
+            _mm256_store_ps(out[i].y.data(), y);
+            _mm256_store_ps(out[i].z.data(), z);
+        }
+#elif defined(STORMKIT_SIMD)
+        const auto columns = make_columns(mat);
+        for (auto i = 0uz; i < std::size(points); ++i) {
+            for (auto lane = 0uz; lane < vec3x8f::WIDTH; lane += 4) {
+                auto x = load(points[i].x.data() + lane);
+                auto y = load(points[i].y.data() + lane);
+                auto z = load(points[i].z.data() + lane);
+                transform(columns, x, y, z);
+                store(out[i].x.data() + lane, x);
+                store(out[i].y.data() + lane, y);
+                store(out[i].z.data() + lane, z);
+            }
+        }
+#else
+        for (auto i = 0uz; i < std::size(points); ++i) {
+            for (auto lane = 0uz; lane < vec3x8f::WIDTH; ++lane) {
+                const auto point = transform_point({ points[i].x[lane],
+                                                     points[i].y[lane],
+                                                     points[i].z[lane] },
+                                                   mat);
+                out[i].x[lane]   = point.x;
+                out[i].y[lane]   = point.y;
+                out[i].z[lane]   = point.z;
+            }
+        }
+#endif
+    }
+
+    ////////////////////////////////////////
+    ////////////////////////////////////////
+    auto mul_batch(std::span<const mat4x4f> a,
+                   std::span<const mat4x4f> b,
+                   std::span<mat4x4f>       out) noexcept -> void {
+        EXPECTS(std::size(a) == std::size(b));
+        EXPECTS(std::size(a) == std::size(out));
+
+        for (auto i = 0uz; i < std::size(a); ++i)
+            simd::mat4_mul(a[i].data(), b[i].data(), out[i].data());
+    }
+
+    ////////////////////////////////////////
+    ////////////////////////////////////////
+    auto mul_batch(std::span<const mat4x4f> a, const mat4x4f& b, std::span<mat4x4f> out) noexcept
+      -> void {
+        EXPECTS(std::size(a) == std::size(out));
+
+#if defined(STORMKIT_SIMD_AVX2)
+        // rows of b stay in registers for the whole batch
+        const auto* b_data = b.data();
+        const auto  b0     = _mm256_broadcast_ps(reinterpret_cast<const __m128*>(b_data));
+        const auto  b1     = _mm256_broadcast_ps(reinterpret_cast<const __m128*>(b_data + 4));
+        const auto  b2     = _mm256_broadcast_ps(reinterpret_cast<const __m128*>(b_data + 8));
+        const auto  b3     = _mm256_broadcast_ps(reinterpret_cast<const __m128*>(b_data + 12));
+
+        const auto rows = [&](__m256 a) noexcept {
+            auto out = _mm256_mul_ps(_mm256_shuffle_ps(a, a, 0x00), b0);
+            out      = fmadd(_mm256_shuffle_ps(a, a, 0x55), b1, out);
+            out      = fmadd(_mm256_shuffle_ps(a, a, 0xAA), b2, out);
+            return fmadd(_mm256_shuffle_ps(a, a, 0xFF), b3, out);
+        };
+
+        for (auto i = 0uz; i < std::size(a); ++i) {
+            const auto a01 = _mm256_loadu_ps(a[i].data());
+            const auto a23 = _mm256_loadu_ps(a[i].data() + 8);
+
+            _mm256_storeu_ps(out[i].data(), rows(a01));
+            _mm256_storeu_ps(out[i].data() + 8, rows(a23));
+        }
+#elif defined(STORMKIT_SIMD)
+        const auto* b_data = b.data();
+        const auto  b0     = load(b_data);
+        const auto  b1     = load(b_data + 4);
+        const auto  b2     = load(b_data + 8);
+        const auto  b3     = load(b_data + 12);
+
+        for (auto i = 0uz; i < std::size(a); ++i) {
+            const auto* a_data = a[i].data();
+            const auto  a0     = load(a_data);
+            const auto  a1     = load(a_data + 4);
+            const auto  a2     = load(a_data + 8);
+            const auto  a3     = load(a_data + 12);
+
+            auto* out_data = out[i].data();
+            store(out_data, mul_row(a0, b0, b1, b2, b3));
+            store(out_data + 4, mul_row(a1, b0, b1, b2, b3));
+            store(out_data + 8, mul_row(a2, b0, b1, b2, b3));
+            store(out_data + 12, mul_row(a3, b0, b1, b2, b3));
+        }
+#else
+        for (auto i = 0uz; i < std::size(a); ++i)
+            simd::mat4_mul(a[i].data(), b.data(), out[i].data());
+#endif
+    }
+
+    ////////////////////////////////////////
+    ////////////////////////////////////////
+    auto local_to_world(std::span<const mat4x4f> local,
+                        std::span<const u32>     parents,
+                        std::span<mat4x4f>       world) noexcept -> void {
+        EXPECTS(std::size(local) == std::size(parents));
+        EXPECTS(std::size(local) == std::size(world));
+
+        for (auto i = 0uz; i < std::size(local); ++i) {
+            const auto parent = parents[i];
+            if (parent == NO_PARENT) {
+                world[i] = local[i];
+                continue;
+            }
+
+            EXPECTS(parent < i);
+            simd::mat4_mul(local[i].data(), world[parent].data(), world[i].data());
+        }
+    }
+}}} // namespace stormkit::core::math
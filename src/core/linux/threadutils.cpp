@@ -1,6 +1,11 @@
 module;
 
+#include <errno.h>
 #include <pthread.h>
+#include <sched.h>
+#include <sys/resource.h>
+#include <sys/syscall.h>
+#include <unistd.h>
 
 module stormkit.core;
 
@@ -22,8 +27,215 @@ namespace stormkit { inline namespace core {
             return std::string { std::begin(name),
                                  std::begin(name) + std::strlen(std::data(name)) };
         }
+
+        ////////////////////////////////////////
+        ////////////////////////////////////////
+        auto set_thread_affinity(pthread_t id, std::span<const u32> cpus) noexcept
+          -> std::expected<void, std::error_code> {
+            auto set = cpu_set_t {};
+            CPU_ZERO(&set);
+            for (const auto cpu : cpus) {
+                if (cpu >= CPU_SETSIZE)
+                    return std::unexpected(std::make_error_code(std::errc::invalid_argument));
+                CPU_SET(cpu, &set);
+            }
+
+            const auto result = pthread_setaffinity_np(id, sizeof(set), &set);
+            if (result != 0) return std::unexpected(std::error_code { result, std::system_category() });
+
+            return {};
+        }
+
+        ////////////////////////////////////////
+        ////////////////////////////////////////
+        auto read_first_line(const std::filesystem::path& path) -> std::optional<std::string> {
+            auto file = std::ifstream { path };
+            if (not file) return std::nullopt;
+
+            auto line = std::string {};
+            if (not std::getline(file, line)) return std::nullopt;
+
+            return line;
+        }
+
+        ////////////////////////////////////////
+        ////////////////////////////////////////
+        auto parse_u32(std::string_view string) noexcept -> std::optional<u32> {
+            auto value        = u32 { 0 };
+            const auto result = std::from_chars(std::data(string),
+                                                std::data(string) + std::size(string),
+                                                value);
+            if (result.ec != std::errc {}) return std::nullopt;
+
+            return value;
+        }
+
+        ////////////////////////////////////////
+        ////////////////////////////////////////
+        /// parse the kernel cpu list format, e.g. "0-3,8,10-11"
+        auto parse_cpu_list(std::string_view list) -> std::vector<u32> {
+            auto cpus = std::vector<u32> {};
+            for (auto&& part : list | std::views::split(',')) {
+                const auto range_string = std::string_view { part };
+                const auto dash         = range_string.find('-');
+
+                const auto first = parse_u32(range_string.substr(0, dash));
+                if (not first) continue;
+
+                const auto last = (dash == std::string_view::npos)
+                                    ? first
+                                    : parse_u32(range_string.substr(dash + 1));
+                if (not last or *last < *first) continue;
+
+                for (auto cpu = *first; cpu <= *last; ++cpu) cpus.emplace_back(cpu);
+            }
+
+            return cpus;
+        }
+
+        ////////////////////////////////////////
+        ////////////////////////////////////////
+        auto read_u32(const std::filesystem::path& path) -> std::optional<u32> {
+            return read_first_line(path).and_then([](const auto& line) static noexcept {
+                return parse_u32(line);
+            });
+        }
+
+        ////////////////////////////////////////
+        ////////////////////////////////////////
+        auto find_numa_node(const std::filesystem::path& cpu_path) -> u32 {
+            auto error = std::error_code {};
+            for (auto it = std::filesystem::directory_iterator { cpu_path, error };
+                 not error and it != std::filesystem::directory_iterator {};
+                 it.increment(error)) {
+                const auto name = it->path().filename().string();
+                if (not name.starts_with("node")) continue;
+
+                if (const auto node = parse_u32(std::string_view { name }.substr(4)); node)
+                    return *node;
+            }
+
+            return 0;
+        }
+
+        ////////////////////////////////////////
+        ////////////////////////////////////////
+        /// the l3 group is keyed by the lowest cpu sharing the cache
+        auto find_l3_key(const std::filesystem::path& cpu_path, u32 cpu) -> u32 {
+            for (auto index = 0u;; ++index) {
+                const auto cache_path = cpu_path / "cache" / std::format("index{}", index);
+
+                const auto level = read_u32(cache_path / "level");
+                if (not level) break;
+                if (*level != 3) continue;
+
+                const auto shared = read_first_line(cache_path / "shared_cpu_list")
+                                      .transform([](const auto& line) static {
+                                          return parse_cpu_list(line);
+                                      })
+                                      .value_or(std::vector<u32> {});
+                if (std::empty(shared)) break;
+
+                return std::ranges::min(shared);
+            }
+
+            return cpu;
+        }
+
+        ////////////////////////////////////////
+        ////////////////////////////////////////
+        /// sysfs paths and the topology itself are allocated, may throw
+        auto read_cpu_topology() -> CpuTopology {
+            static constexpr auto ROOT = "/sys/devices/system/cpu";
+
+            const auto online = read_first_line(std::filesystem::path { ROOT } / "online");
+            if (not online) return make_flat_cpu_topology();
+
+            const auto ids = parse_cpu_list(*online);
+            if (std::empty(ids)) return make_flat_cpu_topology();
+
+            auto topology = CpuTopology {};
+            topology.cpus.reserve(std::size(ids));
+
+            // raw (package, core_id) and l3 keys are sparse, remap them to dense indices
+            auto cores     = std::map<std::pair<u32, u32>, u32> {};
+            auto l3_groups = std::map<u32, u32> {};
+            auto max_node  = u32 { 0 };
+            for (const auto id : ids) {
+                const auto cpu_path = std::filesystem::path { ROOT } / std::format("cpu{}", id);
+
+                const auto package = read_u32(cpu_path / "topology" / "physical_package_id")
+                                       .value_or(0);
+                const auto core_id = read_u32(cpu_path / "topology" / "core_id").value_or(id);
+                const auto node    = find_numa_node(cpu_path);
+                const auto l3_key  = find_l3_key(cpu_path, id);
+
+                const auto core = cores.try_emplace({ package, core_id }, as<u32>(std::size(cores)))
+                                    .first;
+                const auto l3 = l3_groups.try_emplace(l3_key, as<u32>(std::size(l3_groups))).first;
+                max_node      = std::max(max_node, node);
+
+                topology.cpus.emplace_back(LogicalCpu { .id        = id,
+                                                        .core      = core->second,
+                                                        .package   = package,
+                                                        .numa_node = node,
+                                                        .l3_group  = l3->second });
+            }
+
+            topology.core_count      = as<u32>(std::size(cores));
+            topology.numa_node_count = max_node + 1;
+            topology.l3_group_count  = as<u32>(std::size(l3_groups));
+
+            return topology;
+        }
+
+        ////////////////////////////////////////
+        ////////////////////////////////////////
+        auto discover_cpu_topology() noexcept -> CpuTopology {
+            try {
+                return read_cpu_topology();
+            } catch (...) { return make_flat_cpu_topology(); }
+        }
     } // namespace details
 
+    ////////////////////////////////////////
+    ////////////////////////////////////////
+    auto set_current_thread_affinity(std::span<const u32> cpus) noexcept
+      -> std::expected<void, std::error_code> {
+        return details::set_thread_affinity(pthread_self(), cpus);
+    }
+
+    ////////////////////////////////////////
+    ////////////////////////////////////////
+    auto set_thread_affinity(std::thread& thread, std::span<const u32> cpus) noexcept
+      -> std::expected<void, std::error_code> {
+        return details::set_thread_affinity(thread.native_handle(), cpus);
+    }
+
+    ////////////////////////////////////////
+    ////////////////////////////////////////
+    auto set_current_thread_priority(ThreadPriority priority) noexcept
+      -> std::expected<void, std::error_code> {
+        // linux threads are scheduled independently, the nice value of a tid only affects it
+        const auto nice = [priority] noexcept {
+            switch (priority) {
+                case ThreadPriority::Idle: return 19;
+                case ThreadPriority::Low: return 10;
+                case ThreadPriority::Normal: return 0;
+                case ThreadPriority::High: return -5;
+                case ThreadPriority::Highest: return -10;
+            }
+            std::unreachable();
+        }();
+
+        const auto tid = static_cast<id_t>(syscall(SYS_gettid));
+        if (setpriority(PRIO_PROCESS, tid, nice) != 0)
+            return std::unexpected(std::error_code { static_cast<i32>(errno),
+                                                     std::system_category() });
+
+        return {};
+    }
+
     ////////////////////////////////////////
     ////////////////////////////////////////
     auto set_current_thread_name(std::string_view name) noexcept -> void {
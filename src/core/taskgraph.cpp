@@ -0,0 +1,192 @@
+// Copyright (C) 2024 Arthur LAURENT <arthur.laurent4@gmail.com>
+// This file is subject to the license terms in the LICENSE file
+// found in the top-level of this distribution
+
+module;
+
+#include <stormkit/core/contract_macro.hpp>
+
+module stormkit.core;
+
+import std;
+
+namespace stormkit {
+    /////////////////////////////////////
+    /////////////////////////////////////
+    auto TaskGraph::NodeAwaiter::await_ready() const noexcept -> bool {
+        return m_node->waiters.load(std::memory_order_acquire) == done_marker();
+    }
+
+    /////////////////////////////////////
+    /////////////////////////////////////
+    auto TaskGraph::NodeAwaiter::await_suspend(std::coroutine_handle<> handle) noexcept -> bool {
+        m_handle = handle;
+
+        auto head = m_node->waiters.load(std::memory_order_acquire);
+        do {
+            // the node completed in the meantime, don't suspend
+            if (head == done_marker()) return false;
+
+            m_next = head;
+        } while (not m_node->waiters.compare_exchange_weak(head,
+                                                           this,
+                                                           std::memory_order_release,
+                                                           std::memory_order_acquire));
+
+        return true;
+    }
+
+    /////////////////////////////////////
+    /////////////////////////////////////
+    TaskGraph::TaskGraph() : m_run { std::make_shared<Run>() } {
+    }
+
+    /////////////////////////////////////
+    /////////////////////////////////////
+    TaskGraph::~TaskGraph() {
+        wait_run();
+    }
+
+    /////////////////////////////////////
+    /////////////////////////////////////
+    auto TaskGraph::add_dependency(NodeId before, NodeId after) -> void {
+        EXPECTS(is_done());
+        EXPECTS(before < std::size(m_nodes) and after < std::size(m_nodes));
+        EXPECTS(before != after);
+
+        m_nodes[before].successors.emplace_back(after);
+        ++m_nodes[after].predecessor_count;
+    }
+
+    /////////////////////////////////////
+    /////////////////////////////////////
+    auto TaskGraph::dispatch(ThreadPool& pool) -> void {
+        EXPECTS(is_done());
+
+        if (std::empty(m_nodes)) return;
+
+        m_pool = &pool;
+        m_failed.clear(std::memory_order_relaxed);
+        m_exception = nullptr;
+        m_run->remaining.store(as<u32>(std::size(m_nodes)), std::memory_order_relaxed);
+        for (auto& node : m_nodes) {
+            node.pending.store(node.predecessor_count, std::memory_order_relaxed);
+            node.waiters.store(nullptr, std::memory_order_relaxed);
+        }
+
+        // posting a task publish the resets above to the workers
+        for (auto&& [id, node] : m_nodes | std::views::enumerate)
+            if (node.predecessor_count == 0) schedule(as<NodeId>(id));
+    }
+
+    /////////////////////////////////////
+    /////////////////////////////////////
+    auto TaskGraph::wait() const -> void {
+        wait_run();
+
+        if (m_exception) std::rethrow_exception(m_exception);
+    }
+
+    /////////////////////////////////////
+    /////////////////////////////////////
+    auto TaskGraph::wait_run() const noexcept -> void {
+        auto& run = *m_run;
+        for (auto remaining = run.remaining.load(std::memory_order_acquire); remaining > 0;
+             remaining      = run.remaining.load(std::memory_order_acquire))
+            run.remaining.wait(remaining, std::memory_order_acquire);
+    }
+
+    /////////////////////////////////////
+    /////////////////////////////////////
+    auto TaskGraph::is_done(NodeId node) const noexcept -> bool {
+        EXPECTS(node < std::size(m_nodes));
+
+        return m_nodes[node].waiters.load(std::memory_order_acquire) == done_marker();
+    }
+
+    /////////////////////////////////////
+    /////////////////////////////////////
+    auto TaskGraph::done_marker() noexcept -> NodeAwaiter* {
+        static auto marker = NodeAwaiter { nullptr };
+
+        return &marker;
+    }
+
+    /////////////////////////////////////
+    /////////////////////////////////////
+    auto TaskGraph::schedule(NodeId node) noexcept -> void {
+        try {
+            // the task keep the run state alive past the destruction of the graph
+            m_pool->post_task<void>([this, node, run = m_run] { execute(*run, node); },
+                                    ThreadPool::NoFuture);
+        } catch (...) {
+            // reported like a node failure, the node is then skipped inline so the run still
+            // complete
+            fail(std::current_exception());
+            execute(*m_run, node);
+        }
+    }
+
+    /////////////////////////////////////
+    /////////////////////////////////////
+    auto TaskGraph::fail(std::exception_ptr exception) noexcept -> void {
+        if (not m_failed.test_and_set(std::memory_order_acq_rel)) m_exception = std::move(exception);
+    }
+
+    /////////////////////////////////////
+    /////////////////////////////////////
+    auto TaskGraph::execute(Run& run, NodeId id) noexcept -> void {
+        static constexpr auto NO_NODE = std::numeric_limits<NodeId>::max();
+
+        for (auto current = id; current != NO_NODE;) {
+            auto& node = m_nodes[current];
+            if (not m_failed.test(std::memory_order_acquire)) {
+                try {
+                    node.work();
+                } catch (...) { fail(std::current_exception()); }
+            }
+
+            // the last ready successor is run inline as a continuation, the others are posted
+            auto next = NO_NODE;
+            for (auto successor : node.successors) {
+                if (m_nodes[successor].pending.fetch_sub(1, std::memory_order_acq_rel) != 1)
+                    continue;
+
+                if (next != NO_NODE) schedule(next);
+                next = successor;
+            }
+
+            // the waiters are resumed once the node is accounted for, so they can wait for the
+            // run or dispatch the graph again, the continuation is then posted to not be delayed
+            // by them
+            auto* waiters = node.waiters.exchange(done_marker(), std::memory_order_acq_rel);
+            if (waiters != nullptr and next != NO_NODE) {
+                schedule(next);
+                next = NO_NODE;
+            }
+
+            complete(run);
+            resume(waiters);
+            current = next;
+        }
+    }
+
+    /////////////////////////////////////
+    /////////////////////////////////////
+    auto TaskGraph::complete(Run& run) noexcept -> void {
+        // the graph may be destroyed as soon as the last node is accounted for, `run` is owned by
+        // the executing task so it is still alive for the notification
+        if (run.remaining.fetch_sub(1, std::memory_order_acq_rel) == 1) run.remaining.notify_all();
+    }
+
+    /////////////////////////////////////
+    /////////////////////////////////////
+    auto TaskGraph::resume(NodeAwaiter* waiters) noexcept -> void {
+        // the awaiters live in the coroutine frames, not in the graph, and may be gone once resumed
+        while (waiters != nullptr) {
+            auto* next = waiters->m_next;
+            waiters->m_handle.resume();
+            waiters = next;
+        }
+    }
+} // namespace stormkit
@@ -2,24 +2,121 @@
 // This file is subject to the license terms in the LICENSE file
 // found in the top-level of this distribution
 
+module;
+
+#include <stormkit/core/contract_macro.hpp>
+#include <stormkit/core/platform_macro.hpp>
+
+#if defined(_MSC_VER) and not defined(__clang__)
+    #include <intrin.h>
+#endif
+
 module stormkit.core;
 
 import std;
 
 namespace stormkit {
+    namespace {
+        /////////////////////////////////////
+        /////////////////////////////////////
+        STORMKIT_FORCE_INLINE
+        inline auto cpu_relax() noexcept -> void {
+#if defined(_MSC_VER) and not defined(__clang__) and (defined(_M_X64) or defined(_M_IX86))
+            _mm_pause();
+#elif defined(__x86_64__) or defined(__i386__)
+            __builtin_ia32_pause();
+#elif defined(__aarch64__)
+            asm volatile("yield");
+#else
+            std::this_thread::yield();
+#endif
+        }
+
+        /////////////////////////////////////
+        /////////////////////////////////////
+        STORMKIT_FORCE_INLINE
+        inline auto next_random(u64& state) noexcept -> u64 {
+            state ^= state << 13;
+            state ^= state >> 7;
+            state ^= state << 17;
+
+            return state;
+        }
+
+        /////////////////////////////////////
+        /////////////////////////////////////
+        STORMKIT_FORCE_INLINE
+        inline auto store_max(std::atomic<u64>& counter, u64 value) noexcept -> void {
+            auto current = counter.load(std::memory_order_relaxed);
+            while (current < value
+                   and not counter.compare_exchange_weak(current,
+                                                         value,
+                                                         std::memory_order_relaxed)) {}
+        }
+
+        /////////////////////////////////////
+        /////////////////////////////////////
+        STORMKIT_FORCE_INLINE
+        inline auto elapsed_ns(std::chrono::steady_clock::time_point since) noexcept -> u64 {
+            return as<u64>(std::chrono::duration_cast<std::chrono::nanoseconds>(
+                             std::chrono::steady_clock::now() - since)
+                             .count());
+        }
+    } // namespace
+
     /////////////////////////////////////
     /////////////////////////////////////
-    ThreadPool::ThreadPool(ThreadPool&& other) noexcept {
-        auto lock = std::scoped_lock { other.m_mutex };
+    ThreadPool::ThreadPool(const Config& config)
+        : m_priority { config.priority }, m_collect_stats { config.collect_stats } {
+        const auto& topology = cpu_topology();
 
-        m_worker_count = std::exchange(other.m_worker_count, 0u);
-        m_tasks        = std::move(other.m_tasks);
+        auto cores = topology.physical_cores(config.numa_node);
+        EXPECTS(not std::empty(cores));
 
-        m_workers.reserve(m_worker_count);
-        for (const auto i : range(m_worker_count)) {
-            auto& thread = m_workers.emplace_back([this] { worker_main(); });
-            set_thread_name(thread, std::format("StormKit:WorkerThread:{}", i));
+        m_worker_count = (config.worker_count > 0) ? config.worker_count
+                                                   : as<u32>(std::size(cores));
+
+        switch (config.placement) {
+            case Placement::Unpinned:
+                if (config.numa_node)
+                    m_placement.assign(m_worker_count,
+                                       cores | std::views::join | std::ranges::to<std::vector>());
+                break;
+            case Placement::Physical_Cores:
+                m_placement.reserve(m_worker_count);
+                for (const auto i : range(m_worker_count))
+                    m_placement.emplace_back(cores[i % std::size(cores)]);
+                break;
+            case Placement::Logical_Cpus: {
+                // take the first cpu of every core, then their second SMT sibling, etc.
+                auto cpus = std::vector<u32> {};
+                for (auto sibling = 0uz;; ++sibling) {
+                    const auto count = std::size(cpus);
+                    for (const auto& core : cores)
+                        if (sibling < std::size(core)) cpus.emplace_back(core[sibling]);
+                    if (std::size(cpus) == count) break;
+                }
+
+                m_placement.reserve(m_worker_count);
+                for (const auto i : range(m_worker_count))
+                    m_placement.emplace_back(std::vector { cpus[i % std::size(cpus)] });
+                break;
+            }
         }
+
+        start_workers();
+    }
+
+    /////////////////////////////////////
+    /////////////////////////////////////
+    ThreadPool::ThreadPool(ThreadPool&& other) noexcept {
+        other.join_all();
+
+        m_worker_count = std::exchange(other.m_worker_count, 0u);
+        m_placement    = std::move(other.m_placement);
+        m_priority     = other.m_priority;
+        m_collect_stats.store(other.stats_enabled(), std::memory_order_relaxed);
+        start_workers();
     }
 
     /////////////////////////////////////
@@ -28,20 +125,14 @@ namespace stormkit {
         if (&other == this) [[unlikely]]
             return *this;
 
-        auto lock1 = std::unique_lock { other.m_mutex, std::defer_lock };
-        auto lock2 = std::unique_lock { other.m_mutex, std::defer_lock };
-        std::lock(lock1, lock2);
-
         join_all();
+        other.join_all();
 
         m_worker_count = std::exchange(other.m_worker_count, 0u);
-        m_tasks        = std::move(other.m_tasks);
-
-        m_workers.reserve(m_worker_count);
-        for (const auto i : range(m_worker_count)) {
-            auto& thread = m_workers.emplace_back([this] { worker_main(); });
-            set_thread_name(thread, std::format("StormKit:WorkerThread:{}", i));
-        }
+        m_placement    = std::move(other.m_placement);
+        m_priority     = other.m_priority;
+        m_collect_stats.store(other.stats_enabled(), std::memory_order_relaxed);
+        start_workers();
 
         return *this;
     }
@@ -49,31 +140,290 @@ namespace stormkit {
     /////////////////////////////////////
     /////////////////////////////////////
     auto ThreadPool::join_all() -> void {
-        for (const auto _ : range(m_worker_count))
-            post_task<void>(Task::Type::Terminate, [] {}, ThreadPool::NoFuture);
+        if (std::empty(m_workers)) return;
+
+        m_stop.store(true, std::memory_order_seq_cst);
+        m_epoch.fetch_add(1, std::memory_order_release);
+        m_epoch.notify_all();
+
+        for (auto& worker : m_workers)
+            if (worker->thread.joinable()) worker->thread.join();
+
+        m_workers.clear();
 
-        for (auto& thread : m_workers)
-            if (thread.joinable()) thread.join();
+        // tasks posted from outside after the drain are never run
+        for (auto task = m_injected.exchange(nullptr, std::memory_order_acquire); task != nullptr;) {
+            auto* next = task->next;
+            task->discard();
+            release_task(task);
+            task = next;
+        }
+    }
+
+    /////////////////////////////////////
+    /////////////////////////////////////
+    auto ThreadPool::stats() const -> std::vector<WorkerStats> {
+        using std::chrono::nanoseconds;
+
+        return m_workers
+               | std::views::transform([](const auto& worker) noexcept {
+                     const auto& counters = worker->counters;
+                     const auto  load     = [](const auto& counter) static noexcept {
+                         return counter.load(std::memory_order_relaxed);
+                     };
+
+                     return WorkerStats {
+                         .executed_tasks           = load(counters.executed_tasks),
+                         .stolen_tasks             = load(counters.stolen_tasks),
+                         .queue_high_water_mark    = load(counters.queue_high_water_mark),
+                         .injected_high_water_mark = load(counters.injected_high_water_mark),
+                         .idle_time         = nanoseconds { as<i64>(load(counters.idle_ns)) },
+                         .total_start_delay = nanoseconds {
+                           as<i64>(load(counters.total_start_delay_ns)) },
+                         .max_start_delay = nanoseconds {
+                           as<i64>(load(counters.max_start_delay_ns)) },
+                     };
+                 })
+               | std::ranges::to<std::vector>();
+    }
+
+    /////////////////////////////////////
+    /////////////////////////////////////
+    auto ThreadPool::reset_stats() noexcept -> void {
+        for (auto& worker : m_workers) {
+            auto& counters = worker->counters;
+            for (auto* counter : { &counters.executed_tasks,
+                                   &counters.stolen_tasks,
+                                   &counters.queue_high_water_mark,
+                                   &counters.injected_high_water_mark,
+                                   &counters.idle_ns,
+                                   &counters.total_start_delay_ns,
+                                   &counters.max_start_delay_ns })
+                counter->store(0, std::memory_order_relaxed);
+        }
+    }
+
+    /////////////////////////////////////
+    /////////////////////////////////////
+    auto ThreadPool::this_worker() noexcept -> Worker*& {
+        thread_local constinit auto* worker = static_cast<Worker*>(nullptr);
+
+        return worker;
     }
 
     /////////////////////////////////////
     /////////////////////////////////////
-    auto ThreadPool::worker_main() noexcept -> void {
+    auto ThreadPool::is_worker_thread() const noexcept -> bool {
+        const auto* worker = this_worker();
+        return worker != nullptr and worker->pool == this;
+    }
+
+    /////////////////////////////////////
+    /////////////////////////////////////
+    auto ThreadPool::make_task() -> Task* {
+        // default initialized, the inline buffer is only written by emplace
+        return ::new (details::pool_allocate(sizeof(Task))) Task;
+    }
+
+    /////////////////////////////////////
+    /////////////////////////////////////
+    auto ThreadPool::release_task(Task* task) noexcept -> void {
+        std::destroy_at(task);
+        details::pool_deallocate(task, sizeof(Task));
+    }
+
+    /////////////////////////////////////
+    /////////////////////////////////////
+    auto ThreadPool::start_workers() -> void {
+        m_stop.store(false, std::memory_order_relaxed);
+
+        // every deque must exist before a worker try to steal from it
+        m_workers.reserve(m_worker_count);
+        for (const auto i : range(m_worker_count))
+            m_workers.emplace_back(
+              std::make_unique<Worker>(this, i, 0x9E3779B97F4A7C15ull * (as<u64>(i) + 1ull)));
+
+        for (auto&& [i, worker] : m_workers | std::views::enumerate) {
+            worker->thread = std::thread { [this, &worker = *worker] { worker_main(worker); } };
+            set_thread_name(worker->thread, std::format("StormKit:WorkerThread:{}", i));
+        }
+    }
+
+    /////////////////////////////////////
+    /////////////////////////////////////
+    auto ThreadPool::push(Task* task) -> void {
+        const auto collect_stats = stats_enabled();
+        if (collect_stats) task->posted = std::chrono::steady_clock::now();
+
+        if (auto* worker = this_worker(); worker != nullptr and worker->pool == this) {
+            worker->deque.push(task);
+            if (collect_stats)
+                store_max(worker->counters.queue_high_water_mark, worker->deque.size());
+        } else {
+            auto head = m_injected.load(std::memory_order_relaxed);
+            do {
+                task->next = head;
+            } while (not m_injected.compare_exchange_weak(head,
+                                                          task,
+                                                          std::memory_order_release,
+                                                          std::memory_order_relaxed));
+        }
+
+        wake_one();
+    }
+
+    /////////////////////////////////////
+    /////////////////////////////////////
+    auto ThreadPool::worker_main(Worker& worker) noexcept -> void {
+        this_worker() = &worker;
+
+        // best effort, a refused pinning or priority change leave the worker where it is
+        if (not std::empty(m_placement))
+            static_cast<void>(set_current_thread_affinity(m_placement[worker.index]));
+        if (m_priority != ThreadPriority::Normal)
+            static_cast<void>(set_current_thread_priority(m_priority));
+
         for (;;) {
-            auto task = Task {};
+            auto* task = find_task(worker);
+            for (auto i = 0u; task == nullptr and i < SPIN_COUNT; ++i) {
+                cpu_relax();
+                task = find_task(worker);
+            }
 
-            {
-                auto lock = std::unique_lock { m_mutex };
-                if (std::empty(m_tasks))
-                    m_work_signal.wait(lock, [this] { return not std::empty(m_tasks); });
+            if (task != nullptr) {
+                run_task(worker, task);
+                continue;
+            }
 
-                task = std::move(m_tasks.front());
-                m_tasks.pop();
+            // only exit once every pending task has been drained
+            if (m_stop.load(std::memory_order_acquire)) {
+                if (not has_work()) break;
+                continue;
             }
 
-            task.work();
+            park(worker);
+        }
 
-            if (task.type == Task::Type::Terminate) return;
+        this_worker() = nullptr;
+    }
+
+    /////////////////////////////////////
+    /////////////////////////////////////
+    auto ThreadPool::run_task(Worker& worker, Task* task) noexcept -> void {
+        if (task->posted != std::chrono::steady_clock::time_point {}) {
+            const auto delay = elapsed_ns(task->posted);
+
+            auto& counters = worker.counters;
+            counters.executed_tasks.fetch_add(1, std::memory_order_relaxed);
+            counters.total_start_delay_ns.fetch_add(delay, std::memory_order_relaxed);
+            store_max(counters.max_start_delay_ns, delay);
         }
+
+        task->run();
+        release_task(task);
+    }
+
+    /////////////////////////////////////
+    /////////////////////////////////////
+    auto ThreadPool::find_task(Worker& worker) noexcept -> Task* {
+        if (auto* task = worker.deque.pop(); task != nullptr) return task;
+        if (auto* task = take_injected(worker); task != nullptr) return task;
+
+        return steal(worker);
+    }
+
+    /////////////////////////////////////
+    /////////////////////////////////////
+    auto ThreadPool::take_injected(Worker& worker) noexcept -> Task* {
+        if (m_injected.load(std::memory_order_relaxed) == nullptr) return nullptr;
+
+        // take the whole list at once, this avoid the ABA problem of a lock-free pop
+        auto* head = m_injected.exchange(nullptr, std::memory_order_acquire);
+        if (head == nullptr) return nullptr;
+
+        // the list is LIFO, reverse it to run the oldest task first
+        auto* oldest = static_cast<Task*>(nullptr);
+        while (head != nullptr) oldest = std::exchange(head, std::exchange(head->next, oldest));
+
+        // the rest goes into our deque where the other workers can steal it
+        auto* remaining = std::exchange(oldest->next, nullptr);
+        auto  count     = u64 { 1 };
+        while (remaining != nullptr) {
+            auto* next = std::exchange(remaining->next, nullptr);
+            worker.deque.push(remaining);
+            remaining = next;
+            ++count;
+        }
+        if (count > 1) wake_one();
+
+        if (stats_enabled()) {
+            store_max(worker.counters.injected_high_water_mark, count);
+            store_max(worker.counters.queue_high_water_mark, worker.deque.size());
+        }
+
+        return oldest;
+    }
+
+    /////////////////////////////////////
+    /////////////////////////////////////
+    auto ThreadPool::steal(Worker& worker) noexcept -> Task* {
+        const auto count = std::size(m_workers);
+        if (count <= 1) return nullptr;
+
+        const auto first = next_random(worker.seed) % count;
+        for (const auto i : range(count)) {
+            auto& victim = *m_workers[(first + i) % count];
+            if (&victim == &worker) continue;
+
+            if (auto* task = victim.deque.steal(); task != nullptr) {
+                if (stats_enabled())
+                    worker.counters.stolen_tasks.fetch_add(1, std::memory_order_relaxed);
+                return task;
+            }
+        }
+
+        return nullptr;
+    }
+
+    /////////////////////////////////////
+    /////////////////////////////////////
+    auto ThreadPool::has_work() const noexcept -> bool {
+        if (m_injected.load(std::memory_order_relaxed) != nullptr) return true;
+
+        return std::ranges::any_of(m_workers, [](const auto& worker) noexcept {
+            return not worker->deque.empty();
+        });
+    }
+
+    /////////////////////////////////////
+    /////////////////////////////////////
+    auto ThreadPool::wake_one() noexcept -> void {
+        // pairs with the fence in park(), either the sleeper see the new task or we see the
+        // sleeper
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+        if (m_sleeping.load(std::memory_order_relaxed) == 0) return;
+
+        m_epoch.fetch_add(1, std::memory_order_release);
+        m_epoch.notify_one();
+    }
+
+    /////////////////////////////////////
+    /////////////////////////////////////
+    auto ThreadPool::park(Worker& worker) noexcept -> void {
+        const auto epoch = m_epoch.load(std::memory_order_acquire);
+
+        m_sleeping.fetch_add(1, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_seq_cst);
+
+        if (not has_work() and not m_stop.load(std::memory_order_relaxed)) {
+            if (stats_enabled()) {
+                const auto since = std::chrono::steady_clock::now();
+                m_epoch.wait(epoch, std::memory_order_acquire);
+                worker.counters.idle_ns.fetch_add(elapsed_ns(since), std::memory_order_relaxed);
+            } else
+                m_epoch.wait(epoch, std::memory_order_acquire);
+        }
+
+        m_sleeping.fetch_sub(1, std::memory_order_relaxed);
     }
 } // namespace stormkit
@@ -0,0 +1,496 @@
+// Copyright (C) 2024 Arthur LAURENT <arthur.laurent4@gmail.com>
+// This file is subject to the license terms in the LICENSE file
+// found in the top-level of this distribution
+
+module;
+
+#include <stormkit/core/contract_macro.hpp>
+#include <stormkit/core/platform_macro.hpp>
+#include <stormkit/core/simd_macro.hpp>
+
+module stormkit.core;
+
+import std;
+
+namespace stormkit { inline namespace core { namespace math {
+    namespace {
+#if defined(STORMKIT_SIMD)
+        using namespace simd::details;
+
+    #if defined(STORMKIT_SIMD_SSE4)
+        using i32x4 = __m128i;
+    #else
+        using i32x4 = int32x4_t;
+    #endif
+
+        /// SinCos of 4 angles, SinCos<f32x4> would drop the vector type attributes
+        struct SinCosLanes {
+            f32x4 sin;
+            f32x4 cos;
+        };
+
+        ////////////////////////////////////////
+        ////////////////////////////////////////
+        /// Round to nearest even
+        STORMKIT_FORCE_INLINE
+        inline auto round_to_int(f32x4 value) noexcept -> i32x4 {
+    #if defined(STORMKIT_SIMD_SSE4)
+            return _mm_cvtps_epi32(value);
+    #else
+            return vcvtnq_s32_f32(value);
+    #endif
+        }
+
+        ////////////////////////////////////////
+        ////////////////////////////////////////
+        STORMKIT_FORCE_INLINE
+        inline auto as_f32x4(i32x4 value) noexcept -> f32x4 {
+    #if defined(STORMKIT_SIMD_SSE4)
+            return _mm_castsi128_ps(value);
+    #else
+            return vreinterpretq_f32_s32(value);
+    #endif
+        }
+
+        ////////////////////////////////////////
+        ////////////////////////////////////////
+        STORMKIT_FORCE_INLINE
+        inline auto as_i32x4(f32x4 value) noexcept -> i32x4 {
+    #if defined(STORMKIT_SIMD_SSE4)
+            return _mm_castps_si128(value);
+    #else
+            return vreinterpretq_s32_f32(value);
+    #endif
+        }
+
+        ////////////////////////////////////////
+        ////////////////////////////////////////
+        STORMKIT_FORCE_INLINE
+        inline auto to_f32(i32x4 value) noexcept -> f32x4 {
+    #if defined(STORMKIT_SIMD_SSE4)
+            return _mm_cvtepi32_ps(value);
+    #else
+            return vcvtq_f32_s32(value);
+    #endif
+        }
+
+        ////////////////////////////////////////
+        ////////////////////////////////////////
+        STORMKIT_FORCE_INLINE
+        inline auto splat_i32(i32 value) noexcept -> i32x4 {
+    #if defined(STORMKIT_SIMD_SSE4)
+            return _mm_set1_epi32(value);
+    #else
+            return vdupq_n_s32(value);
+    #endif
+        }
+
+        ////////////////////////////////////////
+        ////////////////////////////////////////
+        STORMKIT_FORCE_INLINE
+        inline auto add_i32(i32x4 a, i32x4 b) noexcept -> i32x4 {
+    #if defined(STORMKIT_SIMD_SSE4)
+            return _mm_add_epi32(a, b);
+    #else
+            return vaddq_s32(a, b);
+    #endif
+        }
+
+        ////////////////////////////////////////
+        ////////////////////////////////////////
+        STORMKIT_FORCE_INLINE
+        inline auto bit_and(i32x4 a, i32x4 b) noexcept -> i32x4 {
+    #if defined(STORMKIT_SIMD_SSE4)
+            return _mm_and_si128(a, b);
+    #else
+            return vandq_s32(a, b);
+    #endif
+        }
+
+        ////////////////////////////////////////
+        ////////////////////////////////////////
+        STORMKIT_FORCE_INLINE
+        inline auto bit_or(i32x4 a, i32x4 b) noexcept -> i32x4 {
+    #if defined(STORMKIT_SIMD_SSE4)
+            return _mm_or_si128(a, b);
+    #else
+            return vorrq_s32(a, b);
+    #endif
+        }
+
+        ////////////////////////////////////////
+        ////////////////////////////////////////
+        template<int N>
+        STORMKIT_FORCE_INLINE
+        inline auto shift_left(i32x4 value) noexcept -> i32x4 {
+    #if defined(STORMKIT_SIMD_SSE4)
+            return _mm_slli_epi32(value, N);
+    #else
+            return vshlq_n_s32(value, N);
+    #endif
+        }
+
+        ////////////////////////////////////////
+        ////////////////////////////////////////
+        /// Logical shift
+        template<int N>
+        STORMKIT_FORCE_INLINE
+        inline auto shift_right(i32x4 value) noexcept -> i32x4 {
+    #if defined(STORMKIT_SIMD_SSE4)
+            return _mm_srli_epi32(value, N);
+    #else
+            return vreinterpretq_s32_u32(vshrq_n_u32(vreinterpretq_u32_s32(value), N));
+    #endif
+        }
+
+        ////////////////////////////////////////
+        ////////////////////////////////////////
+        /// All bits set in the lanes where `a < b`
+        STORMKIT_FORCE_INLINE
+        inline auto less(f32x4 a, f32x4 b) noexcept -> f32x4 {
+    #if defined(STORMKIT_SIMD_SSE4)
+            return _mm_cmplt_ps(a, b);
+    #else
+            return vreinterpretq_f32_u32(vcltq_f32(a, b));
+    #endif
+        }
+
+        ////////////////////////////////////////
+        ////////////////////////////////////////
+        /// All bits set in the lanes where `a == b`
+        STORMKIT_FORCE_INLINE
+        inline auto equal(i32x4 a, i32x4 b) noexcept -> f32x4 {
+    #if defined(STORMKIT_SIMD_SSE4)
+            return _mm_castsi128_ps(_mm_cmpeq_epi32(a, b));
+    #else
+            return vreinterpretq_f32_u32(vceqq_s32(a, b));
+    #endif
+        }
+
+        ////////////////////////////////////////
+        ////////////////////////////////////////
+        /// `mask ? a : b` per lane
+        STORMKIT_FORCE_INLINE
+        inline auto select(f32x4 mask, f32x4 a, f32x4 b) noexcept -> f32x4 {
+    #if defined(STORMKIT_SIMD_SSE4)
+            return _mm_blendv_ps(b, a, mask);
+    #else
+            return vbslq_f32(vreinterpretq_u32_f32(mask), a, b);
+    #endif
+        }
+
+        ////////////////////////////////////////
+        ////////////////////////////////////////
+        STORMKIT_FORCE_INLINE
+        inline auto min(f32x4 a, f32x4 b) noexcept -> f32x4 {
+    #if defined(STORMKIT_SIMD_SSE4)
+            return _mm_min_ps(a, b);
+    #else
+            return vminq_f32(a, b);
+    #endif
+        }
+
+        ////////////////////////////////////////
+        ////////////////////////////////////////
+        STORMKIT_FORCE_INLINE
+        inline auto max(f32x4 a, f32x4 b) noexcept -> f32x4 {
+    #if defined(STORMKIT_SIMD_SSE4)
+            return _mm_max_ps(a, b);
+    #else
+            return vmaxq_f32(a, b);
+    #endif
+        }
+
+        ////////////////////////////////////////
+        ////////////////////////////////////////
+        /// x - k * constant computed in f64, see details::PI_2_F64
+        STORMKIT_FORCE_INLINE
+        inline auto reduce(f32x4 x, i32x4 k, f64 constant) noexcept -> f32x4 {
+    #if defined(STORMKIT_SIMD_SSE4)
+            const auto c    = _mm_set1_pd(constant);
+            const auto low  = _mm_sub_pd(_mm_cvtps_pd(x), _mm_mul_pd(_mm_cvtepi32_pd(k), c));
+            const auto high = _mm_sub_pd(_mm_cvtps_pd(_mm_movehl_ps(x, x)),
+                                         _mm_mul_pd(_mm_cvtepi32_pd(_mm_unpackhi_epi64(k, k)), c));
+            return _mm_movelh_ps(_mm_cvtpd_ps(low), _mm_cvtpd_ps(high));
+    #else
+            const auto c    = vdupq_n_f64(constant);
+            const auto low  = vsubq_f64(vcvt_f64_f32(vget_low_f32(x)),
+                                       vmulq_f64(vcvtq_f64_s64(vmovl_s32(vget_low_s32(k))), c));
+            const auto high = vsubq_f64(vcvt_high_f64_f32(x),
+                                        vmulq_f64(vcvtq_f64_s64(vmovl_high_s32(k)), c));
+            return vcvt_high_f32_f64(vcvt_f32_f64(low), high);
+    #endif
+        }
+
+        ////////////////////////////////////////
+        ////////////////////////////////////////
+        template<usize N>
+        STORMKIT_FORCE_INLINE
+        inline auto horner(f32x4 x, const std::array<f32, N>& coefficients) noexcept -> f32x4 {
+            auto result = splat(coefficients[N - 1]);
+            for (auto i = N - 1; i > 0; --i) result = fmadd(result, x, splat(coefficients[i - 1]));
+
+            return result;
+        }
+
+        ////////////////////////////////////////
+        ////////////////////////////////////////
+        /// SIMD version of details::fast_sincos, the quadrant is applied with sign bits instead of
+        /// a switch
+        STORMKIT_FORCE_INLINE
+        inline auto sincos(f32x4 x) noexcept -> SinCosLanes {
+            const auto k = round_to_int(mul(x, splat(details::TWO_OVER_PI)));
+            const auto r = reduce(x, k, details::PI_2_F64);
+            const auto z = mul(r, r);
+
+            const auto sin = fmadd(mul(r, z), horner(z, details::SIN_COEFFICIENTS), r);
+            const auto cos = fmadd(mul(z, z),
+                                   horner(z, details::COS_COEFFICIENTS),
+                                   sub(splat(1.f), mul(splat(0.5f), z)));
+
+            // odd quadrants swap sin and cos, bit 1 of k (of k + 1 for cos) flips the sign
+            const auto one  = splat_i32(1);
+            const auto swap = equal(bit_and(k, one), one);
+            const auto sin_sign = as_f32x4(shift_left<30>(bit_and(k, splat_i32(2))));
+            const auto cos_sign = as_f32x4(shift_left<30>(bit_and(add_i32(k, one), splat_i32(2))));
+
+            return { flip_sign(select(swap, cos, sin), sin_sign),
+                     flip_sign(select(swap, sin, cos), cos_sign) };
+        }
+
+        ////////////////////////////////////////
+        ////////////////////////////////////////
+        /// SIMD version of details::fast_atan2
+        STORMKIT_FORCE_INLINE
+        inline auto atan2(f32x4 y, f32x4 x) noexcept -> f32x4 {
+            const auto zero  = splat(0.f);
+            const auto abs_x = abs(x);
+            const auto abs_y = abs(y);
+            const auto num   = min(abs_x, abs_y);
+            const auto den   = max(abs_x, abs_y);
+
+            // 0 / 0 gives a NaN, replaced by 0
+            auto       t       = select(less(zero, den), div(num, den), zero);
+            const auto reduced = less(splat(details::TAN_PI_8), t);
+            t = select(reduced, div(sub(t, splat(1.f)), add(t, splat(1.f))), t);
+
+            const auto z = mul(t, t);
+            auto       a = fmadd(mul(t, z), horner(z, details::ATAN_COEFFICIENTS), t);
+            a            = select(reduced, add(a, splat(details::PI / 4.f)), a);
+
+            a = select(less(abs_x, abs_y), sub(splat(details::PI / 2.f), a), a);
+            a = select(less(x, zero), sub(splat(details::PI), a), a);
+            return flip_sign(a, y);
+        }
+
+        ////////////////////////////////////////
+        ////////////////////////////////////////
+        /// SIMD version of details::fast_acos
+        STORMKIT_FORCE_INLINE
+        inline auto acos(f32x4 x) noexcept -> f32x4 {
+            const auto abs_x = min(abs(x), splat(1.f));
+
+            const auto reduced = less(splat(0.5f), abs_x);
+            const auto z    = select(reduced, mul(sub(splat(1.f), abs_x), splat(0.5f)), mul(x, x));
+            const auto s    = select(reduced, sqrt(z), abs_x);
+            const auto asin = fmadd(mul(s, z), horner(z, details::ASIN_COEFFICIENTS), s);
+
+            const auto acos = select(reduced,
+                                     add(asin, asin),
+                                     sub(splat(details::PI / 2.f), asin));
+            return select(less(x, splat(0.f)), sub(splat(details::PI), acos), acos);
+        }
+
+        ////////////////////////////////////////
+        ////////////////////////////////////////
+        /// SIMD version of details::fast_exp
+        STORMKIT_FORCE_INLINE
+        inline auto exp(f32x4 x) noexcept -> f32x4 {
+            x = min(max(x, splat(details::EXP_MIN)), splat(details::EXP_MAX));
+
+            const auto n = round_to_int(mul(x, splat(std::numbers::log2e_v<f32>)));
+            const auto r = reduce(x, n, details::LN_2_F64);
+
+            const auto exp = fmadd(mul(r, r),
+                                   horner(r, details::EXP_COEFFICIENTS),
+                                   add(r, splat(1.f)));
+
+            return as_f32x4(add_i32(as_i32x4(exp), shift_left<23>(n)));
+        }
+
+        ////////////////////////////////////////
+        ////////////////////////////////////////
+        /// SIMD version of details::fast_log
+        STORMKIT_FORCE_INLINE
+        inline auto log(f32x4 x) noexcept -> f32x4 {
+            const auto bits     = as_i32x4(x);
+            const auto exponent = add_i32(bit_and(shift_right<23>(bits), splat_i32(0xff)),
+                                          splat_i32(-126));
+            const auto mantissa = as_f32x4(bit_or(bit_and(bits, splat_i32(-0x7f800001)),
+                                                  splat_i32(0x3f000000)));
+
+            // e - 1 and 2m - 1 below sqrt(1/2), e and m - 1 above
+            const auto below = less(mantissa, splat(details::SQRT_1_2));
+            const auto e     = sub(to_f32(exponent), select(below, splat(1.f), splat(0.f)));
+            const auto m     = sub(select(below, add(mantissa, mantissa), mantissa), splat(1.f));
+
+            const auto z   = mul(m, m);
+            const auto log = fmadd(mul(m, z),
+                                   horner(m, details::LOG_COEFFICIENTS),
+                                   sub(m, mul(splat(0.5f), z)));
+            return fmadd(e, splat(std::numbers::ln2_v<f32>), log);
+        }
+#endif
+    } // namespace
+
+    ////////////////////////////////////////
+    ////////////////////////////////////////
+    auto sin_batch(std::span<const f32> x, std::span<f32> out, Precision precision) noexcept
+      -> void {
+        EXPECTS(std::size(x) == std::size(out));
+
+        if (precision == Precision::Exact) {
+            for (auto i = 0uz; i < std::size(x); ++i) out[i] = std::sin(x[i]);
+            return;
+        }
+
+        auto i = 0uz;
+#if defined(STORMKIT_SIMD)
+        for (; i + 4 <= std::size(x); i += 4) store(&out[i], sincos(load(&x[i])).sin);
+#endif
+
+        for (; i < std::size(x); ++i) out[i] = details::fast_sincos(x[i]).sin;
+    }
+
+    ////////////////////////////////////////
+    ////////////////////////////////////////
+    auto cos_batch(std::span<const f32> x, std::span<f32> out, Precision precision) noexcept
+      -> void {
+        EXPECTS(std::size(x) == std::size(out));
+
+        if (precision == Precision::Exact) {
+            for (auto i = 0uz; i < std::size(x); ++i) out[i] = std::cos(x[i]);
+            return;
+        }
+
+        auto i = 0uz;
+#if defined(STORMKIT_SIMD)
+        for (; i + 4 <= std::size(x); i += 4) store(&out[i], sincos(load(&x[i])).cos);
+#endif
+
+        for (; i < std::size(x); ++i) out[i] = details::fast_sincos(x[i]).cos;
+    }
+
+    ////////////////////////////////////////
+    ////////////////////////////////////////
+    auto sincos_batch(std::span<const f32> x,
+                      std::span<f32>       sin,
+                      std::span<f32>       cos,
+                      Precision            precision) noexcept -> void {
+        EXPECTS(std::size(x) == std::size(sin));
+        EXPECTS(std::size(x) == std::size(cos));
+
+        if (precision == Precision::Exact) {
+            for (auto i = 0uz; i < std::size(x); ++i) {
+                const auto angle = x[i];
+                sin[i]           = std::sin(angle);
+                cos[i]           = std::cos(angle);
+            }
+            return;
+        }
+
+        auto i = 0uz;
+#if defined(STORMKIT_SIMD)
+        for (; i + 4 <= std::size(x); i += 4) {
+            const auto result = sincos(load(&x[i]));
+            store(&sin[i], result.sin);
+            store(&cos[i], result.cos);
+        }
+#endif
+
+        for (; i < std::size(x); ++i) {
+            const auto result = details::fast_sincos(x[i]);
+            sin[i]            = result.sin;
+            cos[i]            = result.cos;
+        }
+    }
+
+    ////////////////////////////////////////
+    ////////////////////////////////////////
+    auto atan2_batch(std::span<const f32> y,
+                     std::span<const f32> x,
+                     std::span<f32>       out,
+                     Precision            precision) noexcept -> void {
+        EXPECTS(std::size(y) == std::size(x));
+        EXPECTS(std::size(y) == std::size(out));
+
+        if (precision == Precision::Exact) {
+            for (auto i = 0uz; i < std::size(y); ++i) out[i] = std::atan2(y[i], x[i]);
+            return;
+        }
+
+        auto i = 0uz;
+#if defined(STORMKIT_SIMD)
+        for (; i + 4 <= std::size(y); i += 4) store(&out[i], atan2(load(&y[i]), load(&x[i])));
+#endif
+
+        for (; i < std::size(y); ++i) out[i] = details::fast_atan2(y[i], x[i]);
+    }
+
+    ////////////////////////////////////////
+    ////////////////////////////////////////
+    auto acos_batch(std::span<const f32> x, std::span<f32> out, Precision precision) noexcept
+      -> void {
+        EXPECTS(std::size(x) == std::size(out));
+
+        if (precision == Precision::Exact) {
+            for (auto i = 0uz; i < std::size(x); ++i) out[i] = std::acos(x[i]);
+            return;
+        }
+
+        auto i = 0uz;
+#if defined(STORMKIT_SIMD)
+        for (; i + 4 <= std::size(x); i += 4) store(&out[i], acos(load(&x[i])));
+#endif
+
+        for (; i < std::size(x); ++i) out[i] = details::fast_acos(x[i]);
+    }
+
+    ////////////////////////////////////////
+    ////////////////////////////////////////
+    auto exp_batch(std::span<const f32> x, std::span<f32> out, Precision precision) noexcept
+      -> void {
+        EXPECTS(std::size(x) == std::size(out));
+
+        if (precision == Precision::Exact) {
+            for (auto i = 0uz; i < std::size(x); ++i) out[i] = std::exp(x[i]);
+            return;
+        }
+
+        auto i = 0uz;
+#if defined(STORMKIT_SIMD)
+        for (; i + 4 <= std::size(x); i += 4) store(&out[i], exp(load(&x[i])));
+#endif
+
+        for (; i < std::size(x); ++i) out[i] = details::fast_exp(x[i]);
+    }
+
+    ////////////////////////////////////////
+    ////////////////////////////////////////
+    auto log_batch(std::span<const f32> x, std::span<f32> out, Precision precision) noexcept
+      -> void {
+        EXPECTS(std::size(x) == std::size(out));
+
+        if (precision == Precision::Exact) {
+            for (auto i = 0uz; i < std::size(x); ++i) out[i] = std::log(x[i]);
+            return;
+        }
+
+        auto i = 0uz;
+#if defined(STORMKIT_SIMD)
+        for (; i + 4 <= std::size(x); i += 4) store(&out[i], log(load(&x[i])));
+#endif
+
+        for (; i < std::size(x); ++i) out[i] = details::fast_log(x[i]);
+    }
+}}} // namespace stormkit::core::math
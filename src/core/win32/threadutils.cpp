@@ -58,8 +58,69 @@ namespace stormkit { inline namespace core {
         auto getThreadHandle(T& thread) {
             return reinterpret_cast<HANDLE>(thread.native_handle());
         }
+
+        ////////////////////////////////////////
+        ////////////////////////////////////////
+        auto set_thread_affinity(HANDLE handle, std::span<const u32> cpus) noexcept
+          -> std::expected<void, std::error_code> {
+            // only the first processor group is addressable through an affinity mask
+            auto mask = DWORD_PTR { 0 };
+            for (const auto cpu : cpus) {
+                if (cpu >= sizeof(DWORD_PTR) * 8)
+                    return std::unexpected(std::make_error_code(std::errc::invalid_argument));
+                mask |= DWORD_PTR { 1 } << cpu;
+            }
+
+            if (::SetThreadAffinityMask(handle, mask) == 0)
+                return std::unexpected(std::error_code { static_cast<i32>(::GetLastError()),
+                                                         std::system_category() });
+
+            return {};
+        }
+
+        ////////////////////////////////////////
+        ////////////////////////////////////////
+        auto discover_cpu_topology() noexcept -> CpuTopology {
+            return make_flat_cpu_topology();
+        }
     } // namespace details
 
+    ////////////////////////////////////////
+    ////////////////////////////////////////
+    auto set_current_thread_affinity(std::span<const u32> cpus) noexcept
+      -> std::expected<void, std::error_code> {
+        return details::set_thread_affinity(::GetCurrentThread(), cpus);
+    }
+
+    ////////////////////////////////////////
+    ////////////////////////////////////////
+    auto set_thread_affinity(std::thread& thread, std::span<const u32> cpus) noexcept
+      -> std::expected<void, std::error_code> {
+        return details::set_thread_affinity(details::getThreadHandle(thread), cpus);
+    }
+
+    ////////////////////////////////////////
+    ////////////////////////////////////////
+    auto set_current_thread_priority(ThreadPriority priority) noexcept
+      -> std::expected<void, std::error_code> {
+        const auto value = [priority] noexcept {
+            switch (priority) {
+                case ThreadPriority::Idle: return THREAD_PRIORITY_IDLE;
+                case ThreadPriority::Low: return THREAD_PRIORITY_BELOW_NORMAL;
+                case ThreadPriority::Normal: return THREAD_PRIORITY_NORMAL;
+                case ThreadPriority::High: return THREAD_PRIORITY_ABOVE_NORMAL;
+                case ThreadPriority::Highest: return THREAD_PRIORITY_HIGHEST;
+            }
+            std::unreachable();
+        }();
+
+        if (::SetThreadPriority(::GetCurrentThread(), value) == 0)
+            return std::unexpected(std::error_code { static_cast<i32>(::GetLastError()),
+                                                     std::system_category() });
+
+        return {};
+    }
+
     ////////////////////////////////////////
     ////////////////////////////////////////
     auto set_current_thread_name(std::string_view name) noexcept -> void {
@@ -0,0 +1,156 @@
+// Copyright (C) 2024 Arthur LAURENT <arthur.laurent4@gmail.com>
+// This file is subject to the license terms in the LICENSE file
+// found in the top-level of this distribution
+
+module;
+
+#include <stormkit/core/contract_macro.hpp>
+
+module stormkit.entities;
+
+import std;
+
+import stormkit.core;
+
+namespace stormkit::entities {
+    /////////////////////////////////////
+    /////////////////////////////////////
+    EntityCommandBuffer::EntityCommandBuffer() noexcept = default;
+
+    /////////////////////////////////////
+    /////////////////////////////////////
+    EntityCommandBuffer::~EntityCommandBuffer() {
+        clear();
+    }
+
+    /////////////////////////////////////
+    /////////////////////////////////////
+    EntityCommandBuffer::EntityCommandBuffer(EntityCommandBuffer&& other) noexcept
+        : m_commands { std::move(other.m_commands) }, m_blocks { std::move(other.m_blocks) },
+          m_large_blocks { std::move(other.m_large_blocks) },
+          m_block { std::exchange(other.m_block, 0) }, m_offset { std::exchange(other.m_offset, 0) },
+          m_deferred_count { std::exchange(other.m_deferred_count, 0) },
+          m_remap { std::move(other.m_remap) } {
+        other.m_commands.clear();
+    }
+
+    /////////////////////////////////////
+    /////////////////////////////////////
+    auto EntityCommandBuffer::operator=(EntityCommandBuffer&& other) noexcept
+      -> EntityCommandBuffer& {
+        if (&other == this) [[unlikely]]
+            return *this;
+
+        clear();
+
+        m_commands       = std::move(other.m_commands);
+        m_blocks         = std::move(other.m_blocks);
+        m_large_blocks   = std::move(other.m_large_blocks);
+        m_block          = std::exchange(other.m_block, 0);
+        m_offset         = std::exchange(other.m_offset, 0);
+        m_deferred_count = std::exchange(other.m_deferred_count, 0);
+        m_remap          = std::move(other.m_remap);
+
+        other.m_commands.clear();
+
+        return *this;
+    }
+
+    /////////////////////////////////////
+    /////////////////////////////////////
+    auto EntityCommandBuffer::make_entity() -> Entity {
+        const auto entity = make_entity_handle(m_deferred_count++, DEFERRED_ENTITY_VERSION);
+
+        push(CommandKind::Create, entity);
+
+        return entity;
+    }
+
+    /////////////////////////////////////
+    /////////////////////////////////////
+    auto EntityCommandBuffer::destroy_entity(Entity entity) -> void {
+        EXPECTS(entity != INVALID_ENTITY);
+
+        push(CommandKind::Destroy_Entity, entity);
+    }
+
+    /////////////////////////////////////
+    /////////////////////////////////////
+    auto EntityCommandBuffer::clear() noexcept -> void {
+        for (auto&& command : m_commands)
+            if (command.destroy != nullptr) command.destroy(command.payload);
+
+        m_commands.clear();
+        m_large_blocks.clear();
+        m_block          = 0;
+        m_offset         = 0;
+        m_deferred_count = 0;
+    }
+
+    /////////////////////////////////////
+    /////////////////////////////////////
+    auto EntityCommandBuffer::push(CommandKind kind, Entity entity) -> Command& {
+        return m_commands.emplace_back(Command { .kind = kind, .entity = entity });
+    }
+
+    /////////////////////////////////////
+    /////////////////////////////////////
+    auto EntityCommandBuffer::allocate(usize size, usize alignment) -> std::byte* {
+        if (size + alignment > BLOCK_SIZE) [[unlikely]]
+            return m_large_blocks.emplace_back(std::make_unique_for_overwrite<std::byte[]>(size))
+              .get();
+
+        auto offset = (m_offset + alignment - 1) & ~(alignment - 1);
+        if (m_block < std::size(m_blocks) and offset + size > BLOCK_SIZE) {
+            ++m_block;
+            offset = 0;
+        }
+
+        if (m_block == std::size(m_blocks))
+            m_blocks.emplace_back(std::make_unique_for_overwrite<std::byte[]>(BLOCK_SIZE));
+
+        m_offset = offset + size;
+
+        return m_blocks[m_block].get() + offset;
+    }
+
+    /////////////////////////////////////
+    /////////////////////////////////////
+    auto EntityCommandBuffer::prepare() -> void {
+        m_remap.assign(m_deferred_count, INVALID_ENTITY);
+    }
+
+    /////////////////////////////////////
+    /////////////////////////////////////
+    auto EntityCommandBuffer::create_entities(EntityManager& manager) -> void {
+        for (auto&& command : m_commands)
+            if (command.kind == CommandKind::Create)
+                m_remap[entity_index(command.entity)] = manager.make_entity();
+    }
+
+    /////////////////////////////////////
+    /////////////////////////////////////
+    auto EntityCommandBuffer::apply(EntityManager& manager) -> void {
+        // commands are kept in recording order, a component destroyed then added again on the
+        // same entity must end up present
+        for (auto&& command : m_commands) {
+            if (command.kind == CommandKind::Create) continue;
+
+            const auto entity = resolve(command.entity);
+            if (not manager.has_entity(entity)) [[unlikely]]
+                continue;
+
+            if (command.kind == CommandKind::Destroy_Entity) manager.destroy_entity(entity);
+            else
+                command.apply(manager, entity, command.payload);
+        }
+    }
+
+    /////////////////////////////////////
+    /////////////////////////////////////
+    auto EntityCommandBuffer::resolve(Entity entity) const noexcept -> Entity {
+        if (not is_deferred(entity)) return entity;
+
+        return m_remap[entity_index(entity)];
+    }
+} // namespace stormkit::entities
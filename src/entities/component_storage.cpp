@@ -0,0 +1,145 @@
+// Copyright (C) 2024 Arthur LAURENT <arthur.laurent4@gmail.com>
+// This file is subject to the license terms in the LICENSE file
+// found in the top-level of this distribution
+
+module;
+
+#include <stormkit/core/contract_macro.hpp>
+
+module stormkit.entities;
+
+import std;
+
+import stormkit.core;
+
+namespace stormkit::entities::details {
+    namespace {
+        /////////////////////////////////////
+        /////////////////////////////////////
+        auto store_max(u32& tick, u32 value) noexcept -> void {
+            auto ref     = std::atomic_ref { tick };
+            auto current = ref.load(std::memory_order_relaxed);
+            while (current < value
+                   and not ref.compare_exchange_weak(current, value, std::memory_order_relaxed)) {}
+        }
+    } // namespace
+
+    /////////////////////////////////////
+    /////////////////////////////////////
+    ComponentStorageBase::ComponentStorageBase(Component::Type type) noexcept : m_type { type } {
+    }
+
+    /////////////////////////////////////
+    /////////////////////////////////////
+    ComponentStorageBase::~ComponentStorageBase() = default;
+
+    /////////////////////////////////////
+    /////////////////////////////////////
+    ComponentStorageBase::ComponentStorageBase(ComponentStorageBase&&) noexcept = default;
+
+    /////////////////////////////////////
+    /////////////////////////////////////
+    auto ComponentStorageBase::operator=(ComponentStorageBase&&) noexcept
+      -> ComponentStorageBase& = default;
+
+    /////////////////////////////////////
+    /////////////////////////////////////
+    auto ComponentStorageBase::remove(Entity entity) -> void {
+        EXPECTS(has(entity));
+
+        const auto index = m_sparse[entity_index(entity)];
+        const auto last  = as<u32>(std::size(m_dense) - 1);
+
+        if (index != last) {
+            const auto moved              = m_dense[last];
+            m_dense[index]                = moved;
+            m_sparse[entity_index(moved)] = index;
+
+            // the moved component keep its change status in its new chunk
+            mark_changed(index, changed_tick(last));
+            store_max(m_added_ticks[index / CHUNK_SIZE], added_tick(last));
+        }
+
+        erase_at(index);
+
+        m_dense.pop_back();
+        m_sparse[entity_index(entity)] = INVALID_INDEX;
+    }
+
+    /////////////////////////////////////
+    /////////////////////////////////////
+    auto ComponentStorageBase::clear() -> void {
+        clear_components();
+
+        m_dense.clear();
+        m_sparse.clear();
+        m_changed_ticks.clear();
+        m_added_ticks.clear();
+    }
+
+    /////////////////////////////////////
+    /////////////////////////////////////
+    auto ComponentStorageBase::restore(std::span<const Entity>    entities,
+                                       std::span<const std::byte> bytes) -> void {
+        EXPECTS(is_snapshotable());
+
+        clear();
+
+        m_dense.assign(std::ranges::begin(entities), std::ranges::end(entities));
+        for (auto&& [index, entity] : m_dense | std::views::enumerate) {
+            const auto sparse_index = entity_index(entity);
+            if (sparse_index >= std::size(m_sparse))
+                m_sparse.resize(sparse_index + 1, INVALID_INDEX);
+
+            m_sparse[sparse_index] = as<u32>(index);
+        }
+
+        const auto chunk_count = (std::size(m_dense) + CHUNK_SIZE - 1) / CHUNK_SIZE;
+        m_changed_ticks.assign(chunk_count, 0u);
+        m_added_ticks.assign(chunk_count, 0u);
+
+        restore_components(std::size(entities), bytes);
+    }
+
+    /////////////////////////////////////
+    /////////////////////////////////////
+    auto ComponentStorageBase::mark_changed(u32 index, u32 tick) noexcept -> void {
+        EXPECTS(index < std::size(m_dense));
+
+        store_max(m_changed_ticks[index / CHUNK_SIZE], tick);
+    }
+
+    /////////////////////////////////////
+    /////////////////////////////////////
+    auto ComponentStorageBase::mark_added(u32 index, u32 tick) noexcept -> void {
+        EXPECTS(index < std::size(m_dense));
+
+        store_max(m_added_ticks[index / CHUNK_SIZE], tick);
+        store_max(m_changed_ticks[index / CHUNK_SIZE], tick);
+    }
+
+    /////////////////////////////////////
+    /////////////////////////////////////
+    auto ComponentStorageBase::mark_all(u32 tick) noexcept -> void {
+        for (auto& changed : m_changed_ticks) store_max(changed, tick);
+        for (auto& added : m_added_ticks) store_max(added, tick);
+    }
+
+    /////////////////////////////////////
+    /////////////////////////////////////
+    auto ComponentStorageBase::insert_index(Entity entity) -> u32 {
+        const auto sparse_index = entity_index(entity);
+        if (sparse_index >= std::size(m_sparse)) m_sparse.resize(sparse_index + 1, INVALID_INDEX);
+
+        const auto index = as<u32>(std::size(m_dense));
+        m_dense.emplace_back(entity);
+        m_sparse[sparse_index] = index;
+
+        if (index / CHUNK_SIZE == std::size(m_changed_ticks)) {
+            m_changed_ticks.emplace_back(0u);
+            m_added_ticks.emplace_back(0u);
+        }
+
+        return index;
+    }
+} // namespace stormkit::entities::details
@@ -32,19 +32,29 @@ namespace stormkit::entities {
     /////////////////////////////////////
     /////////////////////////////////////
     auto EntityManager::make_entity() -> Entity {
-        const auto entity = [this]() {
-            if (std::empty(m_free_entities)) return m_next_valid_entity++;
-            else {
-                auto entity = m_free_entities.front();
+        EXPECTS(not m_parallel_step);
+
+        const auto index = [this]() {
+            if (std::empty(m_free_entities)) {
+                const auto index = m_next_valid_index++;
+                m_versions.resize(index + 1, 0u);
+                m_masks.resize(index + 1);
+                m_committed_masks.resize(index + 1);
+                if (index / 64u >= std::size(m_alive)) m_alive.resize(index / 64u + 1, 0u);
+
+                return index;
+            } else {
+                auto index = m_free_entities.front();
                 m_free_entities.pop();
-                return entity;
+                return index;
             }
         }();
 
+        set_alive(index, true);
+        const auto entity = make_entity_handle(index, m_versions[index]);
+
         m_added_entities.emplace(entity);
         m_updated_entities.emplace(entity);
-        m_registered_components_for_entities[entity] = {};
-        m_message_bus.push(Message { ADDED_ENTITY_MESSAGE_ID, { entity } });
 
         return entity;
     }
@@ -52,21 +62,20 @@ namespace stormkit::entities {
     /////////////////////////////////////
     /////////////////////////////////////
     auto EntityManager::destroy_entity(Entity entity) -> void {
+        EXPECTS(not m_parallel_step);
         EXPECTS(entity != INVALID_ENTITY);
 
-        if (has_entity(entity)) {
-            m_removed_entities.emplace(entity);
-            m_message_bus.push(Message { REMOVED_ENTITY_MESSAGE_ID, { entity } });
-        }
+        if (has_entity(entity) and m_removed_entities.emplace(entity).second)
+            m_removed_message_entities.emplace_back(entity);
     }
 
     /////////////////////////////////////
     /////////////////////////////////////
     auto EntityManager::destroy_all_entities() -> void {
-        for (auto&& e : entities()) {
-            m_removed_entities.emplace(e);
-            m_message_bus.push(Message { REMOVED_ENTITY_MESSAGE_ID, { e } });
-        }
+        EXPECTS(not m_parallel_step);
+
+        for (auto&& e : entities())
+            if (m_removed_entities.emplace(e).second) m_removed_message_entities.emplace_back(e);
     }
 
     /////////////////////////////////////
@@ -74,8 +83,11 @@ namespace stormkit::entities {
     auto EntityManager::has_entity(Entity entity) const -> bool {
         EXPECTS(entity != INVALID_ENTITY);
 
-        return std::ranges::any_of(entities(), monadic::is(entity))
-               or std::ranges::any_of(m_added_entities, monadic::is(entity));
+        const auto index = entity_index(entity);
+        if (index >= std::size(m_versions)) [[unlikely]]
+            return false;
+
+        return is_alive(index) and m_versions[index] == entity_version(entity);
     }
 
     /////////////////////////////////////
@@ -83,66 +95,293 @@ namespace stormkit::entities {
     auto EntityManager::has_component(Entity entity, Component::Type type) const -> bool {
         EXPECTS(entity != INVALID_ENTITY and type != Component::INVALID_TYPE);
 
-        return std::ranges::any_of(m_registered_components_for_entities.at(entity),
-                                   monadic::is(type));
+        const auto id = find_component_id(type);
+        if (id == INVALID_COMPONENT_ID or not has_entity(entity)) return false;
+
+        return m_masks[entity_index(entity)].test(id);
+    }
+
+    /////////////////////////////////////
+    /////////////////////////////////////
+    auto EntityManager::register_component_type(Component::Type type) -> u32 {
+        EXPECTS(type != Component::INVALID_TYPE);
+
+        const auto id = find_component_id(type);
+        if (id != INVALID_COMPONENT_ID) return id;
+
+        const auto new_id = as<u32>(std::size(m_storages));
+        EXPECTS(new_id < MAX_COMPONENT_TYPES);
+
+        m_component_ids.emplace(type, new_id);
+        m_storages.emplace_back(nullptr);
+        m_systems_by_component.emplace_back();
+
+        return new_id;
+    }
+
+    /////////////////////////////////////
+    /////////////////////////////////////
+    auto EntityManager::make_mask(const System::ComponentTypes& types) -> ComponentMask {
+        auto mask = ComponentMask {};
+        for (auto type : types) mask.set(register_component_type(type));
+
+        return mask;
     }
 
     /////////////////////////////////////
     /////////////////////////////////////
     auto EntityManager::step(Secondf delta) -> void {
-        for (auto entity : m_removed_entities) {
-            auto it = m_registered_components_for_entities.find(entity);
-            // a this point, all entities should be valid
-            ensures(it != std::ranges::cend(m_registered_components_for_entities));
+        flush();
 
-            for (auto&& key : it->second | std::views::transform([entity](auto&& type) {
-                                  return component_key_for(entity, type);
-                              }))
-                m_components.erase(key);
+        for (auto& system : m_systems) system->pre_update();
+        for (auto& system : m_systems) system->update(delta);
+        for (auto& system : m_systems) system->post_update();
+    }
+
+    /////////////////////////////////////
+    /////////////////////////////////////
+    auto EntityManager::step(Secondf delta, ThreadPool& pool) -> void {
+        EXPECTS(pool.worker_count() > 0);
+        EXPECTS(not pool.is_worker_thread());
+
+        flush();
+
+        if (m_schedule_dirty) build_schedule();
+
+        m_parallel_step = true;
+        try {
+            run_schedule(pool, [](System& system) { system.pre_update(); });
+            run_schedule(pool, [delta](System& system) { system.update(delta); });
+            run_schedule(pool, [](System& system) { system.post_update(); });
+        } catch (...) {
+            m_parallel_step = false;
+            throw;
+        }
+        m_parallel_step = false;
+    }
+
+    /////////////////////////////////////
+    /////////////////////////////////////
+    auto EntityManager::make_command_buffer() -> EntityCommandBuffer {
+        auto lock = std::unique_lock { *m_command_buffers_mutex };
+
+        if (std::empty(m_free_command_buffers)) return EntityCommandBuffer {};
+
+        auto buffer = std::move(m_free_command_buffers.back());
+        m_free_command_buffers.pop_back();
+
+        return buffer;
+    }
+
+    /////////////////////////////////////
+    /////////////////////////////////////
+    auto EntityManager::submit(EntityCommandBuffer&& buffer) -> void {
+        if (buffer.empty()) return;
+
+        auto lock = std::unique_lock { *m_command_buffers_mutex };
+
+        m_pending_command_buffers.emplace_back(std::move(buffer));
+    }
+
+    /////////////////////////////////////
+    /////////////////////////////////////
+    auto EntityManager::apply_command_buffers() -> void {
+        {
+            auto lock = std::unique_lock { *m_command_buffers_mutex };
+            std::swap(m_pending_command_buffers, m_applying_command_buffers);
+        }
+
+        if (std::empty(m_applying_command_buffers)) return;
+
+        // entities are created up front so any buffer can reference them, the remaining commands
+        // are applied in submission then recording order
+        for (auto&& buffer : m_applying_command_buffers) {
+            buffer.prepare();
+            buffer.create_entities(*this);
+        }
+        for (auto&& buffer : m_applying_command_buffers) buffer.apply(*this);
+
+        auto lock = std::unique_lock { *m_command_buffers_mutex };
+        for (auto&& buffer : m_applying_command_buffers) {
+            buffer.clear();
+            m_free_command_buffers.emplace_back(std::move(buffer));
+        }
+        m_applying_command_buffers.clear();
+    }
+
+    /////////////////////////////////////
+    /////////////////////////////////////
+    auto EntityManager::flush() -> void {
+        for (auto& system : m_systems) {
+            system->m_added_entities.clear();
+            system->m_removed_entities.clear();
+        }
+
+        for (auto&& channel : m_event_channels | std::views::values) channel->swap();
+
+        apply_command_buffers();
+
+        // removed entities are notified before being torn down, so systems can still query their
+        // components. Entities created and destroyed during the same step never joined a system
+        // and are filtered out here
+        if (not std::empty(m_removed_message_entities)) {
+            auto message = Message { REMOVED_ENTITY_MESSAGE_ID, std::move(m_message_entities) };
+            for (auto& system : m_systems) {
+                message.entities.clear();
+                std::ranges::copy_if(m_removed_message_entities,
+                                     std::back_inserter(message.entities),
+                                     [&system](auto entity) {
+                                         return system->m_entities.contains(entity);
+                                     });
+                if (not std::empty(message.entities)) system->on_message_received(message);
+            }
+
+            // messages are delivered synchronously, give their storage back so the next frames
+            // reuse it instead of reallocating
+            m_message_entities = std::move(message.entities);
+            m_removed_message_entities.clear();
+        }
+
+        for (auto entity : m_removed_entities) {
+            for (auto&& storage : m_storages)
+                if (storage != nullptr and storage->has(entity)) storage->remove(entity);
 
             m_entities.erase(entity);
+            m_added_entities.erase(entity);
+            m_updated_entities.erase(entity);
 
             remove_from_systems(entity);
 
-            if (not std::ranges::any_of(m_added_entities, monadic::is(entity)))
-                m_free_entities.push(entity);
+            const auto index = entity_index(entity);
+            m_masks[index].reset();
+            m_committed_masks[index].reset();
+            set_alive(index, false);
+            if (++m_versions[index] == EntityCommandBuffer::DEFERRED_ENTITY_VERSION)
+                m_versions[index] = 0;
+            m_free_entities.push(index);
         }
         m_removed_entities.clear();
 
+        for (auto entity : m_updated_entities)
+            update_systems_membership(entity, m_added_entities.contains(entity));
+        m_updated_entities.clear();
+
         std::ranges::for_each(m_added_entities, [this](auto&& entity) {
             m_entities.emplace(entity);
         });
         m_added_entities.clear();
 
-        std::ranges::for_each(m_updated_entities, [this](auto&& entity) {
-            purpose_to_systems(entity);
-        });
-        m_updated_entities.clear();
+        auto message = Message { ADDED_ENTITY_MESSAGE_ID, std::move(m_message_entities) };
+        for (auto& system : m_systems) {
+            if (std::empty(system->m_added_entities)) continue;
 
-        while (!m_message_bus.empty()) {
-            for (auto& system : m_systems) system->on_message_received(m_message_bus.top());
-            m_message_bus.pop();
+            message.entities.assign(std::ranges::begin(system->m_added_entities),
+                                    std::ranges::end(system->m_added_entities));
+            system->on_message_received(message);
         }
+        m_message_entities = std::move(message.entities);
+        m_message_entities.clear();
+    }
 
-        for (auto& system : m_systems) system->pre_update();
-        for (auto& system : m_systems) system->update(delta);
-        for (auto& system : m_systems) system->post_update();
+    /////////////////////////////////////
+    /////////////////////////////////////
+    auto EntityManager::build_schedule() -> void {
+        m_schedule.clear();
+        m_schedule.reserve(std::size(m_systems));
+
+        for (auto& system : m_systems) m_schedule.emplace_back(as_ref_mut(*system));
+
+        // m_systems is sorted by priority, systems of a priority level wait for every system of
+        // the previous level, inside a level only conflicting systems are ordered. Edges to the
+        // levels after the next one are implied and not added
+        for (auto i : range(std::size(m_schedule))) {
+            const auto& system     = *m_schedule[i].system;
+            auto        next_level = std::optional<u32> {};
+            for (auto j : range(i + 1, std::size(m_schedule))) {
+                const auto& other = *m_schedule[j].system;
+                if (other.priority() == system.priority()) {
+                    if (not system.conflicts_with(other)) continue;
+                } else if (not next_level)
+                    next_level = other.priority();
+                else if (other.priority() != *next_level)
+                    break;
+
+                m_schedule[i].successors.emplace_back(as<u32>(j));
+                ++m_schedule[j].predecessor_count;
+            }
+        }
+
+        m_schedule_dirty = false;
+    }
+
+    /////////////////////////////////////
+    /////////////////////////////////////
+    auto EntityManager::register_system(System& system) -> void {
+        system.m_mask = make_mask(system.components_used());
+        if (const auto& access = system.component_access(); access) {
+            system.m_read_mask  = make_mask(access->reads);
+            system.m_write_mask = make_mask(access->writes);
+        }
+
+        if (system.m_mask.none()) m_systems_without_signature.emplace_back(as_ref_mut(system));
+        else
+            for (auto id : range(std::size(m_systems_by_component)))
+                if (system.m_mask.test(id))
+                    m_systems_by_component[id].emplace_back(as_ref_mut(system));
+
+        m_schedule_dirty = true;
+
+        get_needed_entities(system);
     }
 
     /////////////////////////////////////
     /////////////////////////////////////
-    auto EntityManager::purpose_to_systems(Entity e) -> void {
+    auto EntityManager::update_systems_membership(Entity e, bool is_new) -> void {
         EXPECTS(e != INVALID_ENTITY);
 
-        const auto reliable_system_filter = [e, this](auto&& system) {
-            for (auto component_type : system->components_used())
-                if (not has_component(e, component_type)) return false;
+        const auto index     = entity_index(e);
+        const auto committed = is_new ? ComponentMask {} : m_committed_masks[index];
+        const auto current   = m_masks[index];
+        const auto changed   = committed ^ current;
+
+        m_committed_masks[index] = current;
+
+        // only systems indexed by a changed component can see their match status flip
+        m_candidate_systems.clear();
+        if (is_new)
+            std::ranges::copy(m_systems_without_signature,
+                              std::back_inserter(m_candidate_systems));
+        if (changed.any())
+            for (auto id : range(std::size(m_systems_by_component)))
+                if (changed.test(id))
+                    std::ranges::copy(m_systems_by_component[id],
+                                      std::back_inserter(m_candidate_systems));
+
+        constexpr auto address = [](const auto& system) static noexcept { return system.get(); };
+        std::ranges::sort(m_candidate_systems, std::less {}, address);
+        const auto duplicates = std::ranges::unique(m_candidate_systems, std::equal_to {}, address);
+        m_candidate_systems.erase(std::ranges::begin(duplicates), std::ranges::end(duplicates));
+
+        for (auto& system : m_candidate_systems) {
+            const auto& signature = system->m_mask;
+            const auto  matched   = not is_new and (committed & signature) == signature;
+            const auto  matches   = (current & signature) == signature;
+
+            if (matches and not matched) system->add_entity(e);
+            else if (matched and not matches)
+                system->remove_entity(e);
+        }
 
-            return true;
-        };
+        if (not is_new and changed.none()) return;
+
+        for (auto& query : m_queries) {
+            const auto matched = not is_new and query->matches(committed);
+            const auto matches = query->matches(current);
 
-        std::ranges::for_each(systems() | std::views::filter(reliable_system_filter),
-                              [e](auto&& system) { system->add_entity(e); });
+            if (matches and not matched) query->m_entities.emplace(e);
+            else if (matched and not matches)
+                query->m_entities.erase(e);
+        }
     }
 
     /////////////////////////////////////
@@ -150,20 +389,60 @@ namespace stormkit::entities {
     auto EntityManager::remove_from_systems(Entity e) -> void {
         EXPECTS(e != INVALID_ENTITY);
 
-        for (auto& s : m_systems) { s->remove_entity(e); }
+        const auto& committed = m_committed_masks[entity_index(e)];
+
+        for (auto& system : m_systems_without_signature) system->remove_entity(e);
+        for (auto id : range(std::size(m_systems_by_component)))
+            if (committed.test(id))
+                for (auto& system : m_systems_by_component[id]) system->remove_entity(e);
+
+        for (auto& query : m_queries) query->m_entities.erase(e);
     }
 
     /////////////////////////////////////
     /////////////////////////////////////
     auto EntityManager::get_needed_entities(System& system) -> void {
-        const auto reliable_entity_filter = [&system, this](auto&& entity) {
-            for (auto component_type : system.components_used())
-                if (not has_component(entity, component_type)) return false;
+        for (auto entity : matching_entities(system.m_mask, {})) system.add_entity(entity);
+    }
 
-            return true;
+    /////////////////////////////////////
+    /////////////////////////////////////
+    auto EntityManager::matching_entities(const ComponentMask& required,
+                                          const ComponentMask& excluded) const
+      -> std::vector<Entity> {
+        const auto matches = [&required, &excluded, this](auto entity) {
+            const auto& mask = m_committed_masks[entity_index(entity)];
+            return m_entities.contains(entity)
+                   and (mask & required) == required
+                   and (mask & excluded).none();
         };
 
-        std::ranges::for_each(entities() | std::views::filter(reliable_entity_filter),
-                              [&system](auto&& e) { system.add_entity(e); });
+        // the smallest storage of the signature bound the candidates to check
+        const auto* smallest = static_cast<const details::ComponentStorageBase*>(nullptr);
+        for (auto id : range(std::size(m_storages))) {
+            if (not required.test(id)) continue;
+
+            const auto* storage = m_storages[id].get();
+            if (storage == nullptr) return {};
+
+            if (smallest == nullptr or storage->size() < smallest->size()) smallest = storage;
+        }
+
+        const auto candidates = (smallest == nullptr) ? std::span { entities() }
+                                                      : smallest->entities();
+
+        return candidates | std::views::filter(matches) | std::ranges::to<std::vector>();
+    }
+
+    /////////////////////////////////////
+    /////////////////////////////////////
+    auto EntityManager::write_tick() noexcept -> u32 {
+        return std::atomic_ref { m_change_tick }.load(std::memory_order_relaxed) + 1;
+    }
+
+    /////////////////////////////////////
+    /////////////////////////////////////
+    auto EntityManager::next_tick() noexcept -> u32 {
+        return std::atomic_ref { m_change_tick }.fetch_add(1, std::memory_order_relaxed) + 1;
     }
 } // namespace stormkit::entities
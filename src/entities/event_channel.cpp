@@ -0,0 +1,19 @@
+// Copyright (C) 2024 Arthur LAURENT <arthur.laurent4@gmail.com>
+// This file is subject to the license terms in the LICENSE file
+// found in the top-level of this distribution
+
+module stormkit.entities;
+
+import std;
+
+import stormkit.core;
+
+namespace stormkit::entities::details {
+    /////////////////////////////////////
+    /////////////////////////////////////
+    EventChannelBase::EventChannelBase() noexcept = default;
+
+    /////////////////////////////////////
+    /////////////////////////////////////
+    EventChannelBase::~EventChannelBase() = default;
+} // namespace stormkit::entities::details
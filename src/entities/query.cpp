@@ -0,0 +1,21 @@
+// Copyright (C) 2024 Arthur LAURENT <arthur.laurent4@gmail.com>
+// This file is subject to the license terms in the LICENSE file
+// found in the top-level of this distribution
+
+module stormkit.entities;
+
+import std;
+
+import stormkit.core;
+
+namespace stormkit::entities::details {
+    /////////////////////////////////////
+    /////////////////////////////////////
+    QueryBase::QueryBase(ComponentMask required, ComponentMask excluded) noexcept
+        : m_required { std::move(required) }, m_excluded { std::move(excluded) } {
+    }
+
+    /////////////////////////////////////
+    /////////////////////////////////////
+    QueryBase::~QueryBase() = default;
+} // namespace stormkit::entities::details
@@ -0,0 +1,465 @@
+// Copyright (C) 2024 Arthur LAURENT <arthur.laurent4@gmail.com>
+// This file is subject to the license terms in the LICENSE file
+// found in the top-level of this distribution
+
+module;
+
+#include <stormkit/core/contract_macro.hpp>
+
+module stormkit.entities;
+
+import std;
+
+import stormkit.core;
+
+namespace stormkit::entities {
+    namespace {
+        struct DeltaHeader {
+            static constexpr auto MAGIC   = u32 { 0x44454b53 }; // SKED
+            static constexpr auto VERSION = u32 { 2 };
+
+            u32 magic;
+            u32 version;
+            u64 size;
+            u64 base_size;
+            u64 base_hash;
+            u32 block_size;
+            u32 block_count;
+        };
+
+        /////////////////////////////////////
+        /////////////////////////////////////
+        /// FNV-1a, stable across builds and platforms unlike std::hash so deltas can be sent
+        /// over the network
+        auto hash_snapshot(std::span<const std::byte> bytes) noexcept -> u64 {
+            auto hash = u64 { 0xcbf29ce484222325 };
+            for (auto byte : bytes) hash = (hash ^ static_cast<u64>(byte)) * u64 { 0x100000001b3 };
+
+            return hash;
+        }
+
+        /////////////////////////////////////
+        /////////////////////////////////////
+        constexpr auto align_snapshot(usize offset) noexcept -> usize {
+            return (offset + SNAPSHOT_ALIGNMENT - 1) & ~(SNAPSHOT_ALIGNMENT - 1);
+        }
+
+        class Writer {
+          public:
+            explicit Writer(std::span<std::byte> output) noexcept : m_output { output } {}
+
+            auto write(std::span<const std::byte> bytes) noexcept -> void {
+                EXPECTS(m_offset + std::size(bytes) <= std::size(m_output));
+
+                if (not std::empty(bytes))
+                    std::memcpy(std::data(m_output) + m_offset, std::data(bytes), std::size(bytes));
+
+                const auto end = align_snapshot(m_offset + std::size(bytes));
+                std::ranges::fill(m_output.subspan(m_offset + std::size(bytes),
+                                                   end - m_offset - std::size(bytes)),
+                                  std::byte { 0 });
+                m_offset = end;
+            }
+
+            template<class T>
+            auto write(const T& value) noexcept -> void {
+                write(std::as_bytes(std::span { &value, 1 }));
+            }
+
+            [[nodiscard]]
+            auto offset() const noexcept -> usize {
+                return m_offset;
+            }
+
+          private:
+            std::span<std::byte> m_output;
+            usize                m_offset = 0;
+        };
+
+        class Reader {
+          public:
+            explicit Reader(std::span<const std::byte> input) noexcept : m_input { input } {}
+
+            auto read(usize size) noexcept
+              -> std::expected<std::span<const std::byte>, SnapshotError> {
+                if (size > std::size(m_input) - m_offset) [[unlikely]]
+                    return std::unexpected(SnapshotError::Truncated);
+
+                const auto bytes = m_input.subspan(m_offset, size);
+                m_offset         = std::min(align_snapshot(m_offset + size), std::size(m_input));
+
+                return bytes;
+            }
+
+            template<class T>
+            auto read() noexcept -> std::expected<T, SnapshotError> {
+                return read(sizeof(T)).transform([](auto bytes) static noexcept {
+                    auto value = T {};
+                    std::memcpy(&value, std::data(bytes), sizeof(T));
+                    return value;
+                });
+            }
+
+            /// `count` elements of `element_size` bytes, a size which doesn't fit in usize can't
+            /// be in the blob either
+            auto read(usize count, usize element_size) noexcept
+              -> std::expected<std::span<const std::byte>, SnapshotError> {
+                const auto overflows = element_size != 0
+                                       and count > std::numeric_limits<usize>::max() / element_size;
+                if (overflows) [[unlikely]]
+                    return std::unexpected(SnapshotError::Truncated);
+
+                return read(count * element_size);
+            }
+
+            template<class T>
+            auto read_into(std::vector<T>& output, usize count) noexcept
+              -> std::expected<void, SnapshotError> {
+                return read(count, sizeof(T)).transform([&output, count](auto bytes) noexcept {
+                    output.resize(count);
+                    if (count > 0) std::memcpy(std::data(output), std::data(bytes), std::size(bytes));
+                });
+            }
+
+          private:
+            std::span<const std::byte> m_input;
+            usize                      m_offset = 0;
+        };
+
+        /////////////////////////////////////
+        /////////////////////////////////////
+        auto is_snapshotable(const std::unique_ptr<details::ComponentStorageBase>& storage) noexcept
+          -> bool {
+            return storage != nullptr and storage->is_snapshotable();
+        }
+    } // namespace
+
+    /////////////////////////////////////
+    /////////////////////////////////////
+    auto EntityManager::snapshot_size() const noexcept -> usize {
+        auto size = align_snapshot(sizeof(SnapshotHeader));
+        size += align_snapshot(std::size(m_versions) * sizeof(u32));
+        size += align_snapshot(std::size(m_alive) * sizeof(u64));
+        size += align_snapshot(std::size(m_free_entities) * sizeof(u32));
+
+        for (auto&& storage : m_storages | std::views::filter(is_snapshotable)) {
+            size += align_snapshot(sizeof(SnapshotStorageHeader));
+            size += align_snapshot(storage->size() * sizeof(Entity));
+            size += align_snapshot(std::size(storage->component_bytes()));
+        }
+
+        return size;
+    }
+
+    /////////////////////////////////////
+    /////////////////////////////////////
+    auto EntityManager::snapshot(std::span<std::byte> output) const -> usize {
+        const auto size = snapshot_size();
+        EXPECTS(std::size(output) >= size);
+
+        auto writer = Writer { output };
+
+        writer.write(SnapshotHeader {
+          .magic            = SnapshotHeader::MAGIC,
+          .version          = SnapshotHeader::VERSION,
+          .next_valid_index = m_next_valid_index,
+          .slot_count       = as<u32>(std::size(m_versions)),
+          .free_count       = as<u32>(std::size(m_free_entities)),
+          .storage_count    = as<u32>(std::ranges::count_if(m_storages, is_snapshotable)),
+          .size             = size,
+        });
+        writer.write(std::as_bytes(std::span { m_versions }));
+        writer.write(std::as_bytes(std::span { m_alive }));
+
+        // std::queue doesn't expose its storage, the free list is written in pop order
+        auto free_entities = m_free_entities;
+        auto free_list     = std::vector<u32> {};
+        free_list.reserve(std::size(free_entities));
+        for (; not std::empty(free_entities); free_entities.pop())
+            free_list.emplace_back(free_entities.front());
+        writer.write(std::as_bytes(std::span { free_list }));
+
+        for (auto&& storage : m_storages | std::views::filter(is_snapshotable)) {
+            writer.write(SnapshotStorageHeader {
+              .type           = storage->type(),
+              .component_size = as<u32>(storage->component_size()),
+              .count          = as<u32>(storage->size()),
+            });
+            writer.write(std::as_bytes(storage->entities()));
+            writer.write(storage->component_bytes());
+        }
+
+        ENSURES(writer.offset() == size);
+
+        return size;
+    }
+
+    /////////////////////////////////////
+    /////////////////////////////////////
+    auto EntityManager::restore(std::span<const std::byte> snapshot)
+      -> std::expected<void, SnapshotError> {
+        auto reader = Reader { snapshot };
+
+        const auto header = reader.read<SnapshotHeader>();
+        if (not header) return std::unexpected(header.error());
+        if (header->magic != SnapshotHeader::MAGIC)
+            return std::unexpected(SnapshotError::Invalid_Magic);
+        if (header->version != SnapshotHeader::VERSION)
+            return std::unexpected(SnapshotError::Unsupported_Version);
+        if (header->size > std::size(snapshot)) return std::unexpected(SnapshotError::Truncated);
+
+        // validate every storage before touching the world, so a failed restore leave it intact
+        const auto alive_count = (header->slot_count + 63u) / 64u;
+
+        auto versions  = std::vector<u32> {};
+        auto alive     = std::vector<u64> {};
+        auto free_list = std::vector<u32> {};
+        if (auto result = reader.read_into(versions, header->slot_count); not result)
+            return result;
+        if (auto result = reader.read_into(alive, alive_count); not result) return result;
+        if (auto result = reader.read_into(free_list, header->free_count); not result)
+            return result;
+
+        const auto is_alive_slot = [&alive](u32 index) noexcept {
+            return (alive[index / 64u] >> (index % 64u) & 1u) != 0;
+        };
+
+        // slot 0 is INVALID_ENTITY, it is never handed out
+        if (header->slot_count > 0 and is_alive_slot(0))
+            return std::unexpected(SnapshotError::Invalid_Entity);
+
+        // a free slot must be dead and listed once, otherwise make_entity would hand it out twice
+        auto       listed       = std::vector<bool>(header->slot_count, false);
+        const auto is_free_slot = [&listed, &is_alive_slot](u32 index) noexcept {
+            if (index == 0 or index >= std::size(listed) or is_alive_slot(index) or listed[index])
+                return false;
+
+            listed[index] = true;
+            return true;
+        };
+        if (header->next_valid_index > header->slot_count
+            or not std::ranges::all_of(free_list, is_free_slot))
+            return std::unexpected(SnapshotError::Invalid_Entity);
+
+        // stored entities index m_masks below, they must be alive slots of this snapshot
+        const auto is_valid = [&versions, &is_alive_slot](Entity entity) noexcept {
+            const auto index = entity_index(entity);
+            return index < std::size(versions)
+                   and versions[index] == entity_version(entity)
+                   and is_alive_slot(index);
+        };
+
+        // a storage list an entity once, a duplicate would leave a dense entry the sparse index
+        // doesn't point to
+        auto       stored    = std::vector<bool>(header->slot_count, false);
+        const auto is_unique = [&stored](Entity entity) noexcept {
+            auto&& bit = stored[entity_index(entity)];
+            if (bit) return false;
+
+            bit = true;
+            return true;
+        };
+
+        struct StorageRecord {
+            details::ComponentStorageBase* storage;
+            std::vector<Entity>            entities;
+            std::span<const std::byte>     bytes;
+            u32                            id;
+        };
+
+        auto records = std::vector<StorageRecord> {};
+        records.reserve(header->storage_count);
+        for (auto _ : range(header->storage_count)) {
+            const auto storage_header = reader.read<SnapshotStorageHeader>();
+            if (not storage_header) return std::unexpected(storage_header.error());
+
+            const auto id = find_component_id(storage_header->type);
+            if (id == INVALID_COMPONENT_ID or not is_snapshotable(m_storages[id]))
+                return std::unexpected(SnapshotError::Unknown_Component_Type);
+
+            auto& storage = *m_storages[id];
+            if (storage.component_size() != storage_header->component_size)
+                return std::unexpected(SnapshotError::Component_Size_Mismatch);
+
+            auto entities = std::vector<Entity> {};
+            if (auto result = reader.read_into(entities, storage_header->count); not result)
+                return result;
+            if (not std::ranges::all_of(entities, [&is_valid, &is_unique](Entity entity) noexcept {
+                    return is_valid(entity) and is_unique(entity);
+                }))
+                return std::unexpected(SnapshotError::Invalid_Entity);
+            for (auto entity : entities) stored[entity_index(entity)] = false;
+
+            const auto bytes = reader.read(storage_header->count, storage_header->component_size);
+            if (not bytes) return std::unexpected(bytes.error());
+
+            records.emplace_back(&storage, std::move(entities), *bytes, id);
+        }
+
+        reset_state();
+
+        m_next_valid_index = header->next_valid_index;
+        m_versions         = std::move(versions);
+        m_alive            = std::move(alive);
+        m_masks.assign(std::size(m_versions), ComponentMask {});
+        for (auto index : free_list) m_free_entities.push(index);
+
+        // components are written straight from the blob, one copy per storage
+        for (auto&& record : records) {
+            if (std::empty(record.entities)) continue;
+
+            record.storage->restore(record.entities, record.bytes);
+            for (auto entity : record.entities) m_masks[entity_index(entity)].set(record.id);
+        }
+
+        for (auto index : range(as<u32>(std::size(m_versions))))
+            if (is_alive(index)) m_entities.emplace(make_entity_handle(index, m_versions[index]));
+
+        m_committed_masks = m_masks;
+        for (auto& system : m_systems) get_needed_entities(*system);
+        for (auto& query : m_queries)
+            for (auto entity : matching_entities(query->m_required, query->m_excluded))
+                query->m_entities.emplace(entity);
+
+        // restored components are seen as added by every query
+        const auto tick = next_tick();
+        for (auto&& storage : m_storages)
+            if (storage != nullptr) storage->mark_all(tick);
+
+        return {};
+    }
+
+    /////////////////////////////////////
+    /////////////////////////////////////
+    auto EntityManager::reset_state() -> void {
+        for (auto&& storage : m_storages)
+            if (storage != nullptr) storage->clear();
+
+        for (auto& system : m_systems) {
+            system->m_entities.clear();
+            system->m_added_entities.clear();
+            system->m_removed_entities.clear();
+        }
+        for (auto& query : m_queries) query->m_entities.clear();
+
+        m_free_entities = {};
+        m_versions.clear();
+        m_alive.clear();
+        m_masks.clear();
+        m_committed_masks.clear();
+
+        m_entities.clear();
+        m_added_entities.clear();
+        m_updated_entities.clear();
+        m_removed_entities.clear();
+
+        m_removed_message_entities.clear();
+
+        auto lock = std::unique_lock { *m_command_buffers_mutex };
+        for (auto&& buffer : m_pending_command_buffers) {
+            buffer.clear();
+            m_free_command_buffers.emplace_back(std::move(buffer));
+        }
+        m_pending_command_buffers.clear();
+    }
+
+    /////////////////////////////////////
+    /////////////////////////////////////
+    auto make_delta_snapshot(std::span<const std::byte> base, std::span<const std::byte> snapshot)
+      -> std::vector<std::byte> {
+        const auto block_count = (std::size(snapshot) + SNAPSHOT_BLOCK_SIZE - 1)
+                                 / SNAPSHOT_BLOCK_SIZE;
+
+        const auto block = [](std::span<const std::byte> data, usize i) noexcept {
+            const auto offset = i * SNAPSHOT_BLOCK_SIZE;
+            if (offset >= std::size(data)) return std::span<const std::byte> {};
+
+            return data.subspan(offset, std::min(SNAPSHOT_BLOCK_SIZE, std::size(data) - offset));
+        };
+
+        auto changed = std::vector<u32> {};
+        for (auto i : range(block_count))
+            if (not std::ranges::equal(block(snapshot, i), block(base, i)))
+                changed.emplace_back(as<u32>(i));
+
+        const auto size = align_snapshot(sizeof(DeltaHeader))
+                          + align_snapshot(std::size(changed) * sizeof(u32))
+                          + std::size(changed) * SNAPSHOT_BLOCK_SIZE;
+
+        auto output = std::vector<std::byte>(size);
+        auto writer = Writer { output };
+
+        writer.write(DeltaHeader {
+          .magic       = DeltaHeader::MAGIC,
+          .version     = DeltaHeader::VERSION,
+          .size        = std::size(snapshot),
+          .base_size   = std::size(base),
+          .base_hash   = hash_snapshot(base),
+          .block_size  = SNAPSHOT_BLOCK_SIZE,
+          .block_count = as<u32>(std::size(changed)),
+        });
+        writer.write(std::as_bytes(std::span { changed }));
+
+        // blocks are stored with a fixed size, the tail of the last one stay zeroed
+        auto offset = writer.offset();
+        for (auto block_index : changed) {
+            std::ranges::copy(block(snapshot, block_index), std::data(output) + offset);
+            offset += SNAPSHOT_BLOCK_SIZE;
+        }
+
+        return output;
+    }
+
+    /////////////////////////////////////
+    /////////////////////////////////////
+    auto apply_delta_snapshot(std::span<const std::byte> base, std::span<const std::byte> delta)
+      -> std::expected<std::vector<std::byte>, SnapshotError> {
+        auto reader = Reader { delta };
+
+        const auto header = reader.read<DeltaHeader>();
+        if (not header) return std::unexpected(header.error());
+        if (header->magic != DeltaHeader::MAGIC)
+            return std::unexpected(SnapshotError::Invalid_Magic);
+        if (header->version != DeltaHeader::VERSION or header->block_size != SNAPSHOT_BLOCK_SIZE)
+            return std::unexpected(SnapshotError::Unsupported_Version);
+        if (header->base_size != std::size(base) or header->base_hash != hash_snapshot(base))
+            return std::unexpected(SnapshotError::Base_Mismatch);
+
+        auto changed = std::vector<u32> {};
+        if (auto result = reader.read_into(changed, header->block_count); not result)
+            return std::unexpected(result.error());
+
+        // the size is checked before allocating, every byte past the base must come from a block
+        if (header->size > header->base_size + u64 { header->block_count } * SNAPSHOT_BLOCK_SIZE)
+            return std::unexpected(SnapshotError::Truncated);
+        if (header->size > header->base_size) {
+            const auto first_new_block = header->base_size / SNAPSHOT_BLOCK_SIZE;
+            const auto block_end = (header->size + SNAPSHOT_BLOCK_SIZE - 1) / SNAPSHOT_BLOCK_SIZE;
+
+            auto covered = std::vector<bool>(block_end - first_new_block, false);
+            for (auto block_index : changed)
+                if (block_index >= first_new_block and block_index < block_end)
+                    covered[block_index - first_new_block] = true;
+
+            if (not std::ranges::all_of(covered, std::identity {}))
+                return std::unexpected(SnapshotError::Truncated);
+        }
+
+        auto output = std::vector<std::byte>(header->size);
+        std::ranges::copy(base.first(std::min(std::size(base), std::size(output))),
+                          std::data(output));
+
+        for (auto block_index : changed) {
+            const auto bytes = reader.read(SNAPSHOT_BLOCK_SIZE);
+            if (not bytes) return std::unexpected(bytes.error());
+
+            const auto offset = block_index * SNAPSHOT_BLOCK_SIZE;
+            if (offset >= std::size(output)) return std::unexpected(SnapshotError::Truncated);
+
+            const auto count = std::min(SNAPSHOT_BLOCK_SIZE, std::size(output) - offset);
+            std::ranges::copy(bytes->first(count), std::data(output) + offset);
+        }
+
+        return output;
+    }
+} // namespace stormkit::entities
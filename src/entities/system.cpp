@@ -19,6 +19,16 @@ namespace stormkit::entities {
         : m_manager { as_ref(manager) }, m_priority { priority }, m_types { std::move(types) } {
     }
 
+    /////////////////////////////////////
+    /////////////////////////////////////
+    System::System(EntityManager&  manager,
+                   u32             priority,
+                   ComponentTypes  types,
+                   ComponentAccess access)
+        : m_manager { as_ref(manager) }, m_priority { priority }, m_types { std::move(types) },
+          m_access { std::move(access) } {
+    }
+
     /////////////////////////////////////
     /////////////////////////////////////
     System::System(System&&) noexcept = default;
@@ -41,12 +51,21 @@ namespace stormkit::entities {
     auto System::post_update() -> void {
     }
 
+    /////////////////////////////////////
+    /////////////////////////////////////
+    auto System::conflicts_with(const System& other) const noexcept -> bool {
+        if (not m_access or not other.m_access) return true;
+
+        return (m_write_mask & (other.m_read_mask | other.m_write_mask)).any()
+               or (other.m_write_mask & m_read_mask).any();
+    }
+
     /////////////////////////////////////
     /////////////////////////////////////
     auto System::add_entity(Entity e) -> void {
         EXPECTS(e != INVALID_ENTITY);
 
-        m_entities.insert(e);
+        if (m_entities.insert(e).second) m_added_entities.emplace_back(e);
     }
 
     /////////////////////////////////////
@@ -54,6 +73,6 @@ namespace stormkit::entities {
     auto System::remove_entity(Entity e) -> void {
         EXPECTS(e != INVALID_ENTITY);
 
-        m_entities.erase(e);
+        if (m_entities.erase(e) > 0) m_removed_entities.emplace_back(e);
     }
 } // namespace stormkit::entities
@@ -13,5 +13,175 @@ using namespace stormkit::core;
 using namespace std::literals;
 
 namespace {
-    auto _ = test::TestSuite { "core.math.hypercomplex", {} };
+    constexpr auto TOLERANCE = 1e-5f;
+
+    auto is_near(f32 a, f32 b, f32 tolerance = TOLERANCE) -> bool {
+        return std::abs(a - b) <= tolerance * std::max({ 1.f, std::abs(a), std::abs(b) });
+    }
+
+    auto is_near(const math::vec3f& a, const math::vec3f& b) -> bool {
+        return is_near(a.x, b.x) and is_near(a.y, b.y) and is_near(a.z, b.z);
+    }
+
+    auto is_near(const math::quatf& a, const math::quatf& b, f32 tolerance = TOLERANCE) -> bool {
+        return is_near(a.x, b.x, tolerance)
+               and is_near(a.y, b.y, tolerance)
+               and is_near(a.z, b.z, tolerance)
+               and is_near(a.w, b.w, tolerance);
+    }
+
+    /// q and -q are the same rotation
+    auto is_same_rotation(const math::quatf& a, const math::quatf& b) -> bool {
+        return is_near(std::abs(math::dot(a, b)), 1.f);
+    }
+
+    auto make_quats(usize count, f32 offset) -> std::vector<math::quatf> {
+        return std::views::iota(0uz, count)
+               | std::views::transform([offset](auto i) {
+                     const auto value = static_cast<f32>(i) + offset;
+                     const auto axis  = math::normalize(math::vec3f { 1.f, value, -0.5f * value });
+                     return math::from_axis_angle(axis, math::radians(20.f * value));
+                 })
+               | std::ranges::to<std::vector>();
+    }
+
+    auto make_factors(usize count) -> std::vector<f32> {
+        return std::views::iota(0uz, count)
+               | std::views::transform([count](auto i) {
+                     return static_cast<f32>(i) / static_cast<f32>(count - 1);
+                 })
+               | std::ranges::to<std::vector>();
+    }
+
+    auto _ = test::TestSuite {
+        "core.math.hypercomplex",
+        {
+          {
+            "hypercomplex.mul",
+            [] static {
+                const auto a = math::from_axis_angle(math::vec3f { 0.f, 0.f, 1.f },
+                                                     math::radians(90.f));
+                const auto b = math::from_axis_angle(math::vec3f { 1.f, 0.f, 0.f },
+                                                     math::radians(90.f));
+                const auto v = math::vec3f { 1.f, 2.f, 3.f };
+
+                // a * b rotate by b then by a
+                EXPECTS(is_near(math::rotate(math::mul(a, b), v),
+                                math::rotate(a, math::rotate(b, v))));
+                EXPECTS(is_near(math::rotate(a, math::vec3f { 1.f, 0.f, 0.f }),
+                                math::vec3f { 0.f, 1.f, 0.f }));
+
+                EXPECTS(is_near(math::mul(a, math::inverse(a)), math::quatf::identity()));
+                EXPECTS(is_near(math::mul(math::quatf::identity(), b), b));
+
+                constexpr auto c = math::mul(math::quatf { 0.f, 0.f, 1.f, 0.f },
+                                             math::quatf { 1.f, 0.f, 0.f, 0.f });
+                const auto     d = math::mul(math::quatf { 0.f, 0.f, 1.f, 0.f },
+                                         math::quatf { 1.f, 0.f, 0.f, 0.f });
+                EXPECTS(is_near(c, d));
+                EXPECTS(is_near(c, math::quatf { 0.f, 1.f, 0.f, 0.f }));
+            },
+          }, {
+            "hypercomplex.normalize",
+            [] static {
+                const auto value = math::quatf { 1.f, 2.f, -3.f, 4.f };
+
+                const auto exact = math::normalize(value);
+                EXPECTS(is_near(math::dot(exact, exact), 1.f));
+                EXPECTS(is_near(exact.w, 4.f / std::sqrt(30.f)));
+
+                const auto fast = math::normalize<math::Precision::Fast>(value);
+                EXPECTS(is_near(fast, exact, 1e-4f));
+            },
+          }, {
+            "hypercomplex.slerp",
+            [] static {
+                const auto a = math::quatf::identity();
+                const auto b = math::from_axis_angle(math::vec3f { 0.f, 1.f, 0.f },
+                                                     math::radians(120.f));
+
+                EXPECTS(is_near(math::slerp(a, b, 0.f), a));
+                EXPECTS(is_near(math::slerp(a, b, 1.f), b));
+
+                const auto half = math::from_axis_angle(math::vec3f { 0.f, 1.f, 0.f },
+                                                        math::radians(60.f));
+                EXPECTS(is_near(math::slerp(a, b, 0.5f), half));
+
+                // the shortest path is taken when the quaternions are in opposite hemispheres
+                const auto negated = math::quatf { -b.x, -b.y, -b.z, -b.w };
+                EXPECTS(is_same_rotation(math::slerp(a, negated, 0.5f), half));
+
+                for (auto t : { 0.f, 0.1f, 0.25f, 0.5f, 0.8f, 1.f }) {
+                    const auto exact = math::slerp(a, b, t);
+                    const auto fast  = math::slerp<math::Precision::Fast>(a, b, t);
+                    EXPECTS(is_near(fast, exact, 1e-3f));
+                }
+
+                // nlerp keeps the endpoints but not the constant angular speed
+                EXPECTS(is_near(math::nlerp(a, b, 1.f), b));
+                EXPECTS(is_near(math::nlerp(a, b, 0.5f), half));
+            },
+          }, {
+            "hypercomplex.to_mat4x4",
+            [] static {
+                const auto v = math::vec3f { 1.f, -2.f, 0.5f };
+
+                for (const auto& value : make_quats(6, 0.5f)) {
+                    const auto mat     = math::to_mat4x4(value);
+                    const auto rotated = math::mul(math::vec4f { v.x, v.y, v.z, 1.f }, mat);
+                    EXPECTS(is_near(math::vec3f { rotated.x, rotated.y, rotated.z },
+                                    math::rotate(value, v)));
+                    EXPECTS(is_near(rotated.w, 1.f));
+
+                    EXPECTS(is_same_rotation(math::to_quat(mat), value));
+                }
+            },
+          }, {
+            "hypercomplex.batch",
+            [] static {
+                // not a multiple of the SIMD width to go through the tail loop
+                const auto a = make_quats(11, 0.f);
+                const auto b = make_quats(11, 3.f);
+                const auto t = make_factors(11);
+
+                const auto unnormalized = a
+                                          | std::views::transform([](const auto& value) static {
+                                                return math::quatf { value.x * 2.f,
+                                                                     value.y * 2.f,
+                                                                     value.z * 2.f,
+                                                                     value.w * 2.f };
+                                            })
+                                          | std::ranges::to<std::vector>();
+
+                auto out = std::vector<math::quatf>(std::size(a));
+
+                math::normalize_batch(unnormalized, out);
+                for (auto i = 0uz; i < std::size(a); ++i) EXPECTS(is_near(out[i], a[i]));
+
+                math::normalize_batch(unnormalized, out, math::Precision::Fast);
+                for (auto i = 0uz; i < std::size(a); ++i) EXPECTS(is_near(out[i], a[i], 1e-4f));
+
+                math::nlerp_batch(a, b, t, out);
+                for (auto i = 0uz; i < std::size(a); ++i)
+                    EXPECTS(is_near(out[i], math::nlerp(a[i], b[i], t[i])));
+
+                math::slerp_batch(a, b, t, out);
+                for (auto i = 0uz; i < std::size(a); ++i)
+                    EXPECTS(is_near(out[i], math::slerp(a[i], b[i], t[i])));
+
+                math::slerp_batch(a, b, t, out, math::Precision::Fast);
+                for (auto i = 0uz; i < std::size(a); ++i)
+                    EXPECTS(is_near(out[i], math::slerp(a[i], b[i], t[i]), 1e-3f));
+
+                auto mats = std::vector<math::mat4x4f>(std::size(a));
+                math::to_mat4x4_batch(a, mats);
+                for (auto i = 0uz; i < std::size(a); ++i) {
+                    const auto expected = math::to_mat4x4(a[i]);
+                    EXPECTS(std::ranges::equal(mats[i].values, expected.values, [](f32 x, f32 y) {
+                        return is_near(x, y);
+                    }));
+                }
+            },
+          }, },
+    };
 } // namespace
@@ -0,0 +1,143 @@
+// Copyright (C) 2024 Arthur LAURENT <arthur.laurent4@gmail.com>
+// This file is subject to the license terms in the LICENSE file
+// found in the top-level of this distribution
+
+import std;
+
+import stormkit.core;
+import stormkit.test;
+
+#include <stormkit/test/test_macro.hpp>
+
+using namespace stormkit::core;
+using namespace std::literals;
+
+namespace {
+    constexpr auto TOLERANCE = 1e-5f;
+
+    auto is_near(f32 a, f32 b) -> bool {
+        return std::abs(a - b) <= TOLERANCE * std::max({ 1.f, std::abs(a), std::abs(b) });
+    }
+
+    auto is_near(const math::vec3f& a, const math::vec3f& b) -> bool {
+        return is_near(a.x, b.x) and is_near(a.y, b.y) and is_near(a.z, b.z);
+    }
+
+    auto is_near(const math::mat4x4f& a, const math::mat4x4f& b) -> bool {
+        return std::ranges::all_of(std::views::zip(a.values, b.values), [](auto&& pair) static {
+            const auto [x, y] = pair;
+            return is_near(x, y);
+        });
+    }
+
+    auto make_points(usize count) -> std::vector<math::vec3f> {
+        return std::views::iota(0uz, count)
+               | std::views::transform([](auto i) static {
+                     const auto value = static_cast<f32>(i);
+                     return math::vec3f { value, -value * 0.5f, value * 2.f + 1.f };
+                 })
+               | std::ranges::to<std::vector>();
+    }
+
+    auto make_transform() -> math::mat4x4f {
+        return math::translate(math::scale(math::mat4x4f::identity(),
+                                           math::vec3f { 2.f, 0.5f, 3.f }),
+                               math::vec3f { 1.f, -4.f, 2.f });
+    }
+
+    auto reference(const math::vec3f& point, const math::mat4x4f& mat) -> math::vec3f {
+        const auto result = math::mul(math::vec4f { point.x, point.y, point.z, 1.f }, mat);
+        return { result.x, result.y, result.z };
+    }
+
+    auto _ = test::TestSuite {
+        "core.math.linear.batch",
+        {
+          {
+            "linear.batch.transform_points",
+            [] static {
+                // not a multiple of the SIMD width to go through the tail loop
+                const auto points = make_points(11);
+                const auto mat    = make_transform();
+
+                auto result = std::vector<math::vec3f>(std::size(points));
+                math::transform_points(points, mat, result);
+
+                for (auto i = 0uz; i < std::size(points); ++i)
+                    EXPECTS(is_near(result[i], reference(points[i], mat)));
+
+                // in place
+                auto in_place = points;
+                math::transform_points(in_place, mat, in_place);
+                EXPECTS(std::ranges::equal(in_place, result, [](auto&& a, auto&& b) static {
+                    return a.x == b.x and a.y == b.y and a.z == b.z;
+                }));
+            },
+          }, {
+            "linear.batch.transform_points.aosoa",
+            [] static {
+                const auto points = make_points(19);
+                const auto mat    = make_transform();
+
+                auto blocks = std::vector<math::vec3x8f>(math::aosoa_block_count(std::size(points)));
+                EXPECTS(std::size(blocks) == 3);
+
+                math::to_aosoa(points, blocks);
+                EXPECTS(blocks[2].x[3] == 0.f and blocks[2].z[7] == 0.f);
+
+                math::transform_points(blocks, mat, blocks);
+
+                auto result = std::vector<math::vec3f>(std::size(points));
+                math::from_aosoa(blocks, result);
+
+                for (auto i = 0uz; i < std::size(points); ++i)
+                    EXPECTS(is_near(result[i], reference(points[i], mat)));
+            },
+          }, {
+            "linear.batch.mul_batch",
+            [] static {
+                const auto a = std::vector { make_transform(),
+                                             math::mat4x4f::identity(),
+                                             math::inverse(make_transform()) };
+                const auto b = std::vector { math::transpose(make_transform()),
+                                             make_transform(),
+                                             make_transform() };
+
+                auto result = std::vector<math::mat4x4f>(std::size(a));
+                math::mul_batch(a, b, result);
+                for (auto i = 0uz; i < std::size(a); ++i)
+                    EXPECTS(is_near(result[i], math::mul(a[i], b[i])));
+                EXPECTS(is_near(result[2], math::mat4x4f::identity()));
+
+                math::mul_batch(a, b[0], result);
+                for (auto i = 0uz; i < std::size(a); ++i)
+                    EXPECTS(is_near(result[i], math::mul(a[i], b[0])));
+            },
+          }, {
+            "linear.batch.local_to_world",
+            [] static {
+                const auto root  = math::translate(math::mat4x4f::identity(),
+                                                  math::vec3f { 10.f, 0.f, 0.f });
+                const auto child = math::scale(math::mat4x4f::identity(),
+                                               math::vec3f { 2.f, 2.f, 2.f });
+                const auto leaf  = math::translate(math::mat4x4f::identity(),
+                                                  math::vec3f { 0.f, 1.f, 0.f });
+
+                const auto local   = std::vector { root, child, leaf, root };
+                const auto parents = std::vector<u32> { math::NO_PARENT, 0, 1, math::NO_PARENT };
+
+                auto world = std::vector<math::mat4x4f>(std::size(local));
+                math::local_to_world(local, parents, world);
+
+                EXPECTS(is_near(world[0], root));
+                EXPECTS(is_near(world[1], math::mul(child, root)));
+                EXPECTS(is_near(world[2], math::mul(leaf, math::mul(child, root))));
+                EXPECTS(is_near(world[3], root));
+
+                // the leaf origin ends at (0, 1, 0) scaled by 2 then moved by 10 on x
+                const auto origin = reference(math::vec3f { 0.f, 0.f, 0.f }, world[2]);
+                EXPECTS(is_near(origin, math::vec3f { 10.f, 2.f, 0.f }));
+            },
+          }, },
+    };
+} // namespace
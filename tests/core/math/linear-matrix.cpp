@@ -13,6 +13,15 @@ using namespace stormkit::core;
 using namespace std::literals;
 
 namespace {
+    constexpr auto TOLERANCE = 1e-5f;
+
+    auto is_near(const math::mat4f& a, const math::mat4f& b) -> bool {
+        return std::ranges::all_of(std::views::zip(a.values, b.values), [](auto&& pair) static {
+            const auto [x, y] = pair;
+            return std::abs(x - y) <= TOLERANCE * std::max({ 1.f, std::abs(x), std::abs(y) });
+        });
+    }
+
     auto _ = test::TestSuite {
         "core.math.linear.matrix",
         {
@@ -62,6 +71,32 @@ namespace {
                 EXPECTS(is(result[2, 1], 2.f));
                 EXPECTS(is(result[2, 2], -1.f));
             },
+          }, {
+            "linear.matrix.inverse.mat4",
+            [] static {
+                static constexpr auto a = math::mat4f { 2.f, 0.f, 1.f, 0.f, 1.f, 3.f, 0.f, 1.f,
+                                                        0.f, 1.f, 4.f, 0.f, 1.f, 0.f, 0.f, 2.f };
+
+                const auto result = math::inverse(a);
+                EXPECTS(is_near(math::mul(a, result), math::mat4f::identity()));
+                EXPECTS(is_near(math::mul(result, a), math::mat4f::identity()));
+
+                constexpr auto compile_time = math::inverse(a);
+                EXPECTS(is_near(result, compile_time));
+            },
+          }, {
+            "linear.matrix.inverse_affine",
+            [] static {
+                const auto a = math::translate(math::scale(math::mat4f::identity(),
+                                                           math::vec3f { 2.f, 4.f, 0.5f }),
+                                               math::vec3f { 3.f, -2.f, 7.f });
+
+                const auto result = math::inverse_affine(a);
+                EXPECTS(is_near(math::mul(a, result), math::mat4f::identity()));
+                EXPECTS(is_near(result, math::inverse(a)));
+                EXPECTS((result[3, 3] == 1.f));
+                EXPECTS((result[0, 3] == 0.f and result[1, 3] == 0.f and result[2, 3] == 0.f));
+            },
           }, {
             "linear.matrix.is_orthogonal",
             [] static {
@@ -104,6 +139,29 @@ namespace {
                 EXPECTS((result[2, 2] == 80));
                 EXPECTS((result[3, 3] == 260));
             },
+          }, {
+            "linear.matrix.mul.matrix.mat4f",
+            [] static {
+                static constexpr auto a = math::mat4f { 1.f,  2.f,  3.f,  4.f,  5.f,  6.f,
+                                                        7.f,  8.f,  9.f,  10.f, 11.f, 12.f,
+                                                        13.f, 14.f, 15.f, 16.f };
+                static constexpr auto b = math::transpose(a);
+
+                const auto     result       = math::mul(a, b);
+                constexpr auto compile_time = math::mul(a, b);
+                EXPECTS(result.values == compile_time.values);
+                EXPECTS((result[0, 0] == 30.f));
+                EXPECTS((result[3, 3] == 13.f * 13.f + 14.f * 14.f + 15.f * 15.f + 16.f * 16.f));
+            },
+          }, {
+            "linear.matrix.mul.vector",
+            [] static {
+                const auto a = math::translate(math::mat4f::identity(), math::vec3f { 3, 2, 3 });
+                const auto b = math::vec4f { 1.f, 2.f, 3.f, 1.f };
+
+                const auto result = math::mul(b, a);
+                EXPECTS(result.x == 4.f and result.y == 4.f and result.z == 6.f and result.w == 1.f);
+            },
           }, {
             "linear.matrix.div.matrix",
             [] static {
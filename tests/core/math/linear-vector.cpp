@@ -83,6 +83,31 @@ namespace {
                 EXPECTS(is(result.x, 1.f / std::sqrt(1.f + 4.f)));
                 EXPECTS(result.y == 2.f / std::sqrt(1.f + 4.f));
             },
+          }, {
+            "linear.vector.vec4f",
+            [] static {
+                const auto a = math::vec4f { 1.f, 2.f, 3.f, 4.f };
+                const auto b = math::vec4f { 4.f, 3.f, 2.f, 1.f };
+
+                const auto sum = add(a, b);
+                EXPECTS(sum.x == 5.f and sum.y == 5.f and sum.z == 5.f and sum.w == 5.f);
+
+                const auto difference = sub(a, b);
+                EXPECTS(difference.x == -3.f and difference.w == 3.f);
+
+                const auto scaled = mul(a, 2.f);
+                EXPECTS(scaled.x == 2.f and scaled.y == 4.f and scaled.z == 6.f and scaled.w == 8.f);
+
+                EXPECTS(math::dot(a, b) == 20.f);
+
+                const auto normalized = math::normalize(math::vec4f { 1.f, 1.f, 1.f, 1.f });
+                EXPECTS(is(normalized.x, 0.5f) and is(normalized.w, 0.5f));
+
+                // the compile time path must agree with the runtime one
+                constexpr auto compile_time = math::dot(math::vec4f { 1.f, 2.f, 3.f, 4.f },
+                                                        math::vec4f { 4.f, 3.f, 2.f, 1.f });
+                EXPECTS(compile_time == math::dot(a, b));
+            },
           }, },
     };
 } // namespace
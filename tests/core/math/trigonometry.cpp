@@ -13,5 +13,202 @@ using namespace stormkit::core;
 using namespace std::literals;
 
 namespace {
-    auto _ = test::TestSuite { "core.math.trigonometry", {} };
+    // documented bounds of the Precision::Fast versions, measured against f64 references
+    constexpr auto SINCOS_ERROR = 1.5e-7;
+    constexpr auto ANGLE_ERROR  = 4e-7;
+    constexpr auto EXP_ERROR    = 1.5e-7;
+
+    auto is_near(f64 value, f64 expected, f64 tolerance) -> bool {
+        return std::abs(value - expected) <= tolerance;
+    }
+
+    auto is_near_relative(f64 value, f64 expected, f64 tolerance) -> bool {
+        return std::abs(value - expected) <= tolerance * std::max(1., std::abs(expected));
+    }
+
+    auto make_values(usize count, f32 from, f32 to) -> std::vector<f32> {
+        return std::views::iota(0uz, count)
+               | std::views::transform([count, from, to](auto i) {
+                     return from + (to - from) * static_cast<f32>(i) / static_cast<f32>(count - 1);
+                 })
+               | std::ranges::to<std::vector>();
+    }
+
+    auto _ = test::TestSuite {
+        "core.math.trigonometry",
+        {
+          {
+            "trigonometry.sincos",
+            [] static {
+                for (auto x : make_values(1'001, -1'000.f, 1'000.f)) {
+                    const auto sin = std::sin(static_cast<f64>(x));
+                    const auto cos = std::cos(static_cast<f64>(x));
+
+                    EXPECTS(is_near(math::sin<math::Precision::Fast>(x), sin, SINCOS_ERROR));
+                    EXPECTS(is_near(math::cos<math::Precision::Fast>(x), cos, SINCOS_ERROR));
+
+                    const auto [fast_sin, fast_cos] = math::sincos<math::Precision::Fast>(x);
+                    EXPECTS(is_near(fast_sin, sin, SINCOS_ERROR));
+                    EXPECTS(is_near(fast_cos, cos, SINCOS_ERROR));
+                }
+
+                // exact quadrant boundaries
+                EXPECTS(math::sin<math::Precision::Fast>(0.f) == 0.f);
+                EXPECTS(math::cos<math::Precision::Fast>(0.f) == 1.f);
+                EXPECTS(is_near(math::sin<math::Precision::Fast>(std::numbers::pi_v<f32> / 2.f),
+                                1.,
+                                SINCOS_ERROR));
+
+                // the default precision is the std one
+                EXPECTS(math::sin(0.3f) == std::sin(0.3f));
+                EXPECTS(math::sincos(0.3).cos == std::cos(0.3));
+
+                constexpr auto value = math::sincos<math::Precision::Fast>(0.5f);
+                EXPECTS(is_near(value.sin, std::sin(0.5), SINCOS_ERROR));
+                EXPECTS(is_near(value.cos, std::cos(0.5), SINCOS_ERROR));
+            },
+          }, {
+            "trigonometry.atan2",
+            [] static {
+                for (auto angle : make_values(361, -3.14f, 3.14f)) {
+                    for (auto radius : { 1e-3f, 1.f, 1e4f }) {
+                        const auto y = radius * std::sin(angle);
+                        const auto x = radius * std::cos(angle);
+                        EXPECTS(is_near(math::atan2<math::Precision::Fast>(y, x),
+                                        std::atan2(static_cast<f64>(y), static_cast<f64>(x)),
+                                        ANGLE_ERROR));
+                    }
+                }
+
+                constexpr auto PI = std::numbers::pi;
+                EXPECTS(math::atan2<math::Precision::Fast>(0.f, 0.f) == 0.f);
+                EXPECTS(is_near(math::atan2<math::Precision::Fast>(0.f, -1.f), PI, ANGLE_ERROR));
+                EXPECTS(is_near(math::atan2<math::Precision::Fast>(1.f, 0.f),
+                                PI / 2.,
+                                ANGLE_ERROR));
+                EXPECTS(is_near(math::atan2<math::Precision::Fast>(-1.f, 0.f),
+                                -PI / 2.,
+                                ANGLE_ERROR));
+            },
+          }, {
+            "trigonometry.acos",
+            [] static {
+                for (auto x : make_values(1'001, -1.f, 1.f))
+                    EXPECTS(is_near(math::acos<math::Precision::Fast>(x),
+                                    std::acos(static_cast<f64>(x)),
+                                    ANGLE_ERROR));
+
+                // dot products of normalized vectors may end up slightly out of [-1, 1]
+                EXPECTS(math::acos<math::Precision::Fast>(1.0001f) == 0.f);
+                EXPECTS(is_near(math::acos<math::Precision::Fast>(-1.0001f),
+                                std::numbers::pi,
+                                ANGLE_ERROR));
+            },
+          }, {
+            "trigonometry.exp_log",
+            [] static {
+                for (auto x : make_values(1'001, -87.f, 88.f)) {
+                    const auto exp = math::exp<math::Precision::Fast>(x);
+                    EXPECTS(is_near(exp, std::exp(static_cast<f64>(x)), EXP_ERROR * exp));
+
+                    EXPECTS(is_near_relative(math::log<math::Precision::Fast>(exp), x, 1e-6));
+                }
+
+                for (auto x : make_values(1'001, 1e-3f, 1e3f))
+                    EXPECTS(is_near_relative(math::log<math::Precision::Fast>(x),
+                                             std::log(static_cast<f64>(x)),
+                                             EXP_ERROR));
+
+                EXPECTS(math::log<math::Precision::Fast>(1.f) == 0.f);
+
+                // saturates instead of overflowing
+                EXPECTS(std::isfinite(math::exp<math::Precision::Fast>(1'000.f)));
+                EXPECTS(math::exp<math::Precision::Fast>(-1'000.f) > 0.f);
+
+                constexpr auto value = math::exp<math::Precision::Fast>(1.f);
+                EXPECTS(is_near(value, std::numbers::e, EXP_ERROR * value));
+            },
+          }, {
+            "trigonometry.batch",
+            [] static {
+                // not a multiple of the SIMD width to go through the tail loop
+                const auto x = make_values(11, -10.f, 10.f);
+                const auto y = make_values(11, 5.f, -7.f);
+
+                auto sin = std::vector<f32>(std::size(x));
+                auto cos = std::vector<f32>(std::size(x));
+                auto out = std::vector<f32>(std::size(x));
+
+                const auto is_same = [](f32 a, f32 b) static { return is_near(a, b, 1e-7); };
+
+                math::sincos_batch(x, sin, cos);
+                for (auto i = 0uz; i < std::size(x); ++i) {
+                    EXPECTS(is_near(sin[i], std::sin(x[i]), 1e-6));
+                    EXPECTS(is_near(cos[i], std::cos(x[i]), 1e-6));
+                }
+
+                math::sincos_batch(x, sin, cos, math::Precision::Fast);
+                for (auto i = 0uz; i < std::size(x); ++i) {
+                    const auto angle = static_cast<f64>(x[i]);
+                    EXPECTS(is_near(sin[i], std::sin(angle), SINCOS_ERROR));
+                    EXPECTS(is_near(cos[i], std::cos(angle), SINCOS_ERROR));
+                }
+
+                math::sin_batch(x, out, math::Precision::Fast);
+                EXPECTS(std::ranges::equal(out, sin, is_same));
+                math::cos_batch(x, out, math::Precision::Fast);
+                EXPECTS(std::ranges::equal(out, cos, is_same));
+
+                math::atan2_batch(y, x, out, math::Precision::Fast);
+                for (auto i = 0uz; i < std::size(x); ++i)
+                    EXPECTS(is_near(out[i],
+                                    std::atan2(static_cast<f64>(y[i]), static_cast<f64>(x[i])),
+                                    ANGLE_ERROR));
+
+                math::acos_batch(cos, out, math::Precision::Fast);
+                for (auto i = 0uz; i < std::size(x); ++i)
+                    EXPECTS(is_near(out[i], std::acos(static_cast<f64>(cos[i])), ANGLE_ERROR));
+
+                math::exp_batch(x, out, math::Precision::Fast);
+                for (auto i = 0uz; i < std::size(x); ++i)
+                    EXPECTS(is_near_relative(out[i], std::exp(static_cast<f64>(x[i])), EXP_ERROR));
+
+                // in place
+                math::log_batch(out, out, math::Precision::Fast);
+                for (auto i = 0uz; i < std::size(x); ++i) EXPECTS(is_near(out[i], x[i], 1e-5));
+            },
+          }, {
+            "trigonometry.transforms",
+            [] static {
+                const auto axis  = math::vec3f { 1.f, 2.f, -0.5f };
+                const auto angle = math::radians(75.f);
+
+                const auto exact = math::rotate(math::mat4x4f::identity(), angle, axis);
+                const auto fast  = math::rotate<math::Precision::Fast>(math::mat4x4f::identity(),
+                                                                      angle,
+                                                                      axis);
+                EXPECTS(std::ranges::equal(fast.values, exact.values, [](f32 a, f32 b) static {
+                    return is_near(a, b, 1e-6);
+                }));
+
+                const auto exact_proj = math::perspective(angle, 16.f / 9.f, 0.1f, 100.f);
+                const auto fast_proj  = math::perspective<math::Precision::Fast>(angle,
+                                                                                16.f / 9.f,
+                                                                                0.1f,
+                                                                                100.f);
+                EXPECTS(std::ranges::equal(fast_proj.values,
+                                           exact_proj.values,
+                                           [](f32 a, f32 b) static {
+                                               return is_near_relative(a, b, 1e-6);
+                                           }));
+
+                const auto exact_quat = math::from_axis_angle(math::normalize(axis), angle);
+                const auto fast_quat  = math::from_axis_angle<math::Precision::Fast>(
+                  math::normalize(axis),
+                  angle);
+                EXPECTS(is_near(fast_quat.x, exact_quat.x, 1e-6));
+                EXPECTS(is_near(fast_quat.w, exact_quat.w, 1e-6));
+            },
+          }, },
+    };
 } // namespace
@@ -34,6 +34,75 @@ namespace {
 
                 EXPECTS(locked_int.unsafe() == (ITERATIONS * 2));
             } },
+          { "SeqLocked.consistency",
+            [] static {
+                struct Vec4 {
+                    u32 x, y, z, w;
+                };
+
+                static constexpr auto ITERATIONS = 100'000u;
+                auto                  locked     = SeqLocked { Vec4 { 0, 0, 0, 0 } };
+
+                auto writer = std::async(std::launch::async, [&locked] {
+                    for (auto i : range(1u, ITERATIONS + 1))
+                        locked.update([i](auto& value) noexcept { value = { i, i, i, i }; });
+                });
+
+                // a torn read would mix the components of two writes
+                auto consistent = true;
+                for (auto _ : range(ITERATIONS)) {
+                    const auto value = locked.load();
+                    consistent = consistent and value.x == value.y and value.y == value.z
+                                 and value.z == value.w;
+                }
+                writer.wait();
+
+                EXPECTS(consistent);
+                EXPECTS(locked.load().w == ITERATIONS);
+            } },
+          { "RcuLocked.snapshot",
+            [] static {
+                auto locked = RcuLocked<std::vector<int>> { 1, 2, 3 };
+
+                {
+                    const auto snapshot = locked.read();
+                    EXPECTS(std::size(*snapshot) == 3);
+                }
+
+                locked.update([](auto& values) { values.emplace_back(4); });
+                EXPECTS(locked.copy() == std::vector { 1, 2, 3, 4 });
+
+                locked.assign({ 5 });
+                EXPECTS(locked.read()->front() == 5);
+            } },
+          { "RcuLocked.concurrent",
+            [] static {
+                static constexpr auto ITERATIONS = 2'000;
+                auto                  locked     = RcuLocked<std::vector<int>> {};
+
+                auto writer = std::async(std::launch::async, [&locked] {
+                    for (auto i : range(ITERATIONS))
+                        locked.update([i](auto& values) { values.emplace_back(i); });
+                });
+
+                // every published vector must be a prefix of [0, ITERATIONS)
+                const auto reader = [&locked] {
+                    auto valid = true;
+                    for (auto _ : range(ITERATIONS)) {
+                        const auto snapshot = locked.read();
+                        for (auto&& [i, value] : *snapshot | std::views::enumerate)
+                            valid = valid and value == i;
+                    }
+                    return valid;
+                };
+                auto reader_1 = std::async(std::launch::async, reader);
+                auto reader_2 = std::async(std::launch::async, reader);
+
+                writer.wait();
+                EXPECTS(reader_1.get());
+                EXPECTS(reader_2.get());
+                EXPECTS(std::size(locked.copy()) == ITERATIONS);
+            } },
           }
     };
 } // namespace
@@ -0,0 +1,131 @@
+// Copyright (C) 2024 Arthur LAURENT <arthur.laurent4@gmail.com>
+// This file is subject to the license terms in the LICENSE file
+// found in the top-level of this distribution
+
+import std;
+
+import stormkit.core;
+import stormkit.test;
+
+#include <stormkit/test/test_macro.hpp>
+
+using namespace stormkit::core;
+
+namespace {
+    auto _ = test::TestSuite {
+        "Core.parallelism",
+        {
+          { "SpscRingBuffer.push_pop",
+            [] static {
+                auto queue = SpscRingBuffer<std::string> { 3 };
+                EXPECTS(queue.capacity() == 4);
+                EXPECTS(queue.empty());
+
+                for (auto i : range(4)) EXPECTS(queue.try_push(std::to_string(i)));
+                EXPECTS(not queue.try_emplace("full"));
+                EXPECTS(queue.size() == 4);
+
+                EXPECTS(queue.try_pop() == "0");
+                EXPECTS(queue.try_emplace("4"));
+
+                // the remaining values wrap around the end of the ring
+                auto output = std::array<std::string, 8> {};
+                EXPECTS(queue.pop_bulk(output) == 4);
+                EXPECTS(std::ranges::equal(std::span { output }.first(4),
+                                           std::array<std::string, 4> { "1", "2", "3", "4" }));
+                EXPECTS(not queue.try_pop());
+            } },
+          { "SpscRingBuffer.concurrent",
+            [] static {
+                static constexpr auto COUNT = 1'000'000;
+
+                auto queue    = SpscRingBuffer<int> { 1024 };
+                auto producer = std::async(std::launch::async, [&queue] {
+                    auto values = std::array<int, 16> {};
+                    for (auto i = 0; i < COUNT;) {
+                        // mix single and bulk pushes
+                        if (i % 3 == 0) {
+                            if (queue.try_push(i)) ++i;
+                            continue;
+                        }
+
+                        const auto count = std::min<usize>(std::size(values), COUNT - i);
+                        for (auto j : range(count)) values[j] = i + static_cast<int>(j);
+                        i += static_cast<int>(queue.push_bulk(std::span { values }.first(count)));
+                    }
+                });
+
+                auto ordered = true;
+                auto values  = std::array<int, 16> {};
+                for (auto expected = 0; expected < COUNT;) {
+                    const auto count = queue.pop_bulk(values);
+                    for (auto j : range(count)) ordered = ordered and values[j] == expected++;
+                }
+                producer.wait();
+
+                EXPECTS(ordered);
+                EXPECTS(queue.empty());
+            } },
+          { "MpmcRingBuffer.push_pop",
+            [] static {
+                auto queue = MpmcRingBuffer<int> { 1 };
+                EXPECTS(queue.capacity() == 2);
+
+                EXPECTS(queue.try_push(1));
+                EXPECTS(queue.try_push(2));
+                EXPECTS(not queue.try_push(3));
+                EXPECTS(queue.try_pop() == 1);
+                EXPECTS(queue.push_bulk(std::array { 3, 4 }) == 1);
+
+                auto output = std::array<int, 4> {};
+                EXPECTS(queue.pop_bulk(output) == 2);
+                EXPECTS(output[0] == 2 and output[1] == 3);
+                EXPECTS(queue.empty());
+            } },
+          { "MpmcRingBuffer.concurrent",
+            [] static {
+                static constexpr auto THREADS = 4;
+                static constexpr auto COUNT   = 200'000;
+                // every value in [1, TOTAL] is pushed exactly once
+                static constexpr auto TOTAL = u64 { THREADS * COUNT };
+
+                auto queue    = MpmcRingBuffer<u64> { 256 };
+                auto received = std::atomic<u64> { 0 };
+                auto sum      = std::atomic<u64> { 0 };
+
+                auto producers = std::vector<std::future<void>> {};
+                auto consumers = std::vector<std::future<void>> {};
+                for (auto t : range(THREADS)) {
+                    producers.emplace_back(std::async(std::launch::async, [&queue, t] {
+                        for (auto i = 0; i < COUNT;) {
+                            const auto value = as<u64>(t * COUNT + i + 1);
+                            if (i % 2 == 0) {
+                                if (queue.try_push(value)) ++i;
+                                continue;
+                            }
+
+                            const auto values = std::array { value, value + 1 };
+                            const auto count  = std::min(2, COUNT - i);
+                            i += static_cast<int>(
+                              queue.push_bulk(std::span { values }.first(as<usize>(count))));
+                        }
+                    }));
+                    consumers.emplace_back(std::async(std::launch::async, [&] {
+                        auto values = std::array<u64, 8> {};
+                        while (received.load(std::memory_order_relaxed) < TOTAL) {
+                            const auto count = queue.pop_bulk(values);
+                            for (auto j : range(count)) sum.fetch_add(values[j]);
+                            received.fetch_add(count);
+                        }
+                    }));
+                }
+
+                for (auto& future : producers) future.wait();
+                for (auto& future : consumers) future.wait();
+
+                EXPECTS(received.load() == TOTAL);
+                EXPECTS(sum.load() == TOTAL * (TOTAL + 1) / 2);
+            } },
+          }
+    };
+} // namespace
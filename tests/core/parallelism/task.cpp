@@ -0,0 +1,97 @@
+// Copyright (C) 2024 Arthur LAURENT <arthur.laurent4@gmail.com>
+// This file is subject to the license terms in the LICENSE file
+// found in the top-level of this distribution
+
+import std;
+
+import stormkit.core;
+import stormkit.test;
+
+#include <stormkit/test/test_macro.hpp>
+
+using namespace stormkit::core;
+
+namespace {
+    auto square(int value) -> Task<int> {
+        co_return value * value;
+    }
+
+    auto square_on(ThreadPool& pool, int value) -> Task<int> {
+        co_await schedule_on(pool);
+
+        co_return value * value;
+    }
+
+    auto chain(int depth) -> Task<int> {
+        if (depth == 0) co_return 0;
+
+        co_return co_await chain(depth - 1) + 1;
+    }
+
+    auto fail() -> Task<void> {
+        throw std::runtime_error { "error" };
+        co_return;
+    }
+
+    auto _ = test::TestSuite {
+        "Core.parallelism",
+        {
+          { "Task.await",
+            [] static {
+                EXPECTS(sync_wait(square(4)) == 16);
+                // symmetric transfer keep the stack flat
+                EXPECTS(sync_wait(chain(10'000)) == 10'000);
+            } },
+          { "Task.schedule_on",
+            [] static {
+                auto pool = ThreadPool { 2 };
+
+                const auto caller = std::this_thread::get_id();
+                const auto worker = sync_wait([](ThreadPool& pool) -> Task<std::thread::id> {
+                    co_await schedule_on(pool);
+                    co_return std::this_thread::get_id();
+                }(pool));
+
+                EXPECTS(worker != caller);
+            } },
+          { "Task.when_all",
+            [] static {
+                auto pool = ThreadPool { 4 };
+
+                const auto [a, b, c] = sync_wait(
+                  when_all(square_on(pool, 2), square_on(pool, 3), [](ThreadPool& pool) -> Task<> {
+                      co_await schedule_on(pool);
+                  }(pool)));
+
+                auto tasks = std::vector<Task<int>> {};
+                for (auto i : range(64)) tasks.emplace_back(square_on(pool, i));
+                const auto squares = sync_wait(when_all(std::move(tasks)));
+
+                EXPECTS(a == 4);
+                EXPECTS(b == 9);
+                EXPECTS(std::size(squares) == 64);
+                EXPECTS(squares[10] == 100);
+            } },
+          { "Task.when_any",
+            [] static {
+                auto pool = ThreadPool { 2 };
+
+                auto tasks = std::vector<Task<int>> {};
+                for (auto i : range(8)) tasks.emplace_back(square_on(pool, i));
+                const auto result = sync_wait(when_any(std::move(tasks)));
+
+                EXPECTS(result.index < 8);
+                EXPECTS(result.value == static_cast<int>(result.index * result.index));
+            } },
+          { "Task.exception",
+            [] static {
+                auto has_thrown = false;
+                try {
+                    sync_wait(when_all(square(2), fail()));
+                } catch (const std::runtime_error&) { has_thrown = true; }
+
+                EXPECTS(has_thrown);
+            } },
+          }
+    };
+} // namespace
@@ -0,0 +1,215 @@
+// Copyright (C) 2024 Arthur LAURENT <arthur.laurent4@gmail.com>
+// This file is subject to the license terms in the LICENSE file
+// found in the top-level of this distribution
+
+import std;
+
+import stormkit.core;
+import stormkit.test;
+
+#include <stormkit/test/test_macro.hpp>
+
+using namespace stormkit::core;
+
+namespace {
+    struct Detached {
+        struct promise_type {
+            auto get_return_object() noexcept -> Detached { return {}; }
+
+            auto initial_suspend() noexcept -> std::suspend_never { return {}; }
+
+            auto final_suspend() noexcept -> std::suspend_never { return {}; }
+
+            auto return_void() noexcept -> void {}
+
+            auto unhandled_exception() noexcept -> void { std::terminate(); }
+        };
+    };
+
+    auto _ = test::TestSuite {
+        "Core.parallelism",
+        {
+          { "TaskGraph.dependencies",
+            [] static {
+                auto pool  = ThreadPool { 4 };
+                auto graph = TaskGraph {};
+
+                // a -> (b, c) -> d
+                auto order = std::array<std::atomic<int>, 4> {};
+                auto clock = std::atomic<int> { 0 };
+                auto stamp = [&clock, &order](usize node) {
+                    return [&clock, &order, node] { order[node] = clock.fetch_add(1) + 1; };
+                };
+
+                const auto a = graph.add_node(stamp(0));
+                const auto b = graph.add_node(stamp(1));
+                const auto c = graph.add_node(stamp(2));
+                const auto d = graph.add_node(stamp(3));
+                graph.add_dependency(a, b);
+                graph.add_dependency(a, c);
+                graph.add_dependency(b, d);
+                graph.add_dependency(c, d);
+
+                auto success = true;
+                // reused across frames
+                for (auto _ : range(100)) {
+                    clock = 0;
+                    graph.run(pool);
+
+                    success = success
+                              and graph.is_done(d)
+                              and order[0] < order[1]
+                              and order[0] < order[2]
+                              and order[1] < order[3]
+                              and order[2] < order[3];
+                }
+
+                EXPECTS(success);
+            } },
+          { "TaskGraph.exception",
+            [] static {
+                auto pool  = ThreadPool { 2 };
+                auto graph = TaskGraph {};
+
+                auto skipped = std::atomic<bool> { true };
+
+                const auto a = graph.add_node([] { throw std::runtime_error { "error" }; });
+                const auto b = graph.add_node([&skipped] { skipped = false; });
+                graph.add_dependency(a, b);
+
+                auto has_thrown = false;
+                try {
+                    graph.run(pool);
+                } catch (const std::runtime_error&) { has_thrown = true; }
+
+                EXPECTS(has_thrown);
+                EXPECTS(graph.is_done());
+                EXPECTS(skipped.load());
+            } },
+          { "TaskGraph.co_await",
+            [] static {
+                auto pool  = ThreadPool { 2 };
+                auto graph = TaskGraph {};
+
+                auto value   = std::atomic<int> { 0 };
+                auto release = std::atomic<bool> { false };
+
+                const auto producer = graph.add_node([&value, &release] {
+                    release.wait(false);
+                    value = 42;
+                });
+
+                auto observed = std::atomic<int> { -1 };
+                auto resumed  = std::atomic<bool> { false };
+
+                graph.dispatch(pool);
+
+                [](TaskGraph& graph,
+                   TaskGraph::NodeId node,
+                   std::atomic<int>& value,
+                   std::atomic<int>& observed,
+                   std::atomic<bool>& resumed) -> Detached {
+                    co_await graph.node(node);
+
+                    observed = value.load();
+                    resumed  = true;
+                    resumed.notify_all();
+                }(graph, producer, value, observed, resumed);
+
+                release = true;
+                release.notify_all();
+
+                resumed.wait(false);
+                graph.wait();
+
+                EXPECTS(observed.load() == 42);
+            } },
+          { "TaskGraph.co_await_across_runs",
+            [] static {
+                auto pool  = ThreadPool { 2 };
+                auto graph = TaskGraph {};
+
+                auto value   = std::atomic<int> { 0 };
+                auto release = std::atomic<bool> { false };
+
+                const auto producer = graph.add_node([&value, &release] {
+                    release.wait(false);
+                    value.fetch_add(1);
+                });
+
+                auto success = true;
+                for (auto run : range(1, 4)) {
+                    auto observed = std::atomic<int> { -1 };
+                    auto resumed  = std::atomic<bool> { false };
+
+                    release = false;
+                    graph.dispatch(pool);
+
+                    // must not complete on the previous run, the producer is still blocked
+                    [](TaskGraph& graph,
+                       TaskGraph::NodeId node,
+                       std::atomic<int>& value,
+                       std::atomic<int>& observed,
+                       std::atomic<bool>& resumed) -> Detached {
+                        co_await graph.node(node);
+
+                        observed = value.load();
+                        resumed  = true;
+                        resumed.notify_all();
+                    }(graph, producer, value, observed, resumed);
+
+                    success = success and not resumed.load();
+
+                    release = true;
+                    release.notify_all();
+
+                    resumed.wait(false);
+                    graph.wait();
+
+                    success = success and observed.load() == run;
+                }
+
+                EXPECTS(success);
+            } },
+          { "TaskGraph.co_await_then_dispatch",
+            [] static {
+                auto pool  = ThreadPool { 2 };
+                auto graph = TaskGraph {};
+
+                auto count   = std::atomic<int> { 0 };
+                auto release = std::atomic<bool> { false };
+
+                const auto first = graph.add_node([&release] { release.wait(false); });
+                const auto last  = graph.add_node([&count] { count.fetch_add(1); });
+                graph.add_dependency(first, last);
+
+                auto resumed = std::atomic<bool> { false };
+
+                graph.dispatch(pool);
+
+                // awaiting the final node, the run must be done once resumed
+                [](TaskGraph& graph,
+                   ThreadPool& pool,
+                   TaskGraph::NodeId node,
+                   std::atomic<bool>& resumed) -> Detached {
+                    co_await graph.node(node);
+
+                    graph.wait();
+                    graph.dispatch(pool);
+                    graph.wait();
+
+                    resumed = true;
+                    resumed.notify_all();
+                }(graph, pool, last, resumed);
+
+                release = true;
+                release.notify_all();
+
+                resumed.wait(false);
+                graph.wait();
+
+                EXPECTS(count.load() == 2);
+            } },
+          }
+    };
+} // namespace
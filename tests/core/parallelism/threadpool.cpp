@@ -0,0 +1,273 @@
+// Copyright (C) 2024 Arthur LAURENT <arthur.laurent4@gmail.com>
+// This file is subject to the license terms in the LICENSE file
+// found in the top-level of this distribution
+
+import std;
+
+import stormkit.core;
+import stormkit.test;
+
+#include <stormkit/test/test_macro.hpp>
+
+using namespace stormkit::core;
+
+namespace {
+    auto _ = test::TestSuite {
+        "Core.parallelism",
+        {
+          { "ThreadPool.post_task",
+            [] static {
+                auto pool = ThreadPool { 4 };
+
+                auto futures = std::vector<std::future<int>> {};
+                for (auto i : range(1'000)) futures.emplace_back(pool.post_task<int>([i] {
+                    return i * 2;
+                }));
+
+                auto success = true;
+                for (auto&& [i, future] : futures | std::views::enumerate)
+                    success = success and future.get() == i * 2;
+
+                EXPECTS(success);
+            } },
+          { "ThreadPool.nested_tasks",
+            [] static {
+                static constexpr auto TASK_COUNT = 64;
+                static constexpr auto CHILDREN   = 256;
+
+                auto pool    = ThreadPool { 4 };
+                auto counter = std::atomic<int> { 0 };
+
+                // children are pushed on the worker deque and stolen by the idle workers
+                for (auto _ : range(TASK_COUNT))
+                    pool.post_task<void>(
+                      [&pool, &counter] {
+                          for (auto _ : range(CHILDREN))
+                              pool.post_task<void>(
+                                [&counter] { counter.fetch_add(1, std::memory_order_relaxed); },
+                                ThreadPool::NoFuture);
+                      },
+                      ThreadPool::NoFuture);
+
+                pool.join_all();
+
+                EXPECTS(counter.load() == TASK_COUNT * CHILDREN);
+            } },
+          { "ThreadPool.is_worker_thread",
+            [] static {
+                auto pool  = ThreadPool { 2 };
+                auto other = ThreadPool { 1 };
+
+                EXPECTS(not pool.is_worker_thread());
+
+                auto on_pool  = pool.post_task<bool>([&pool] { return pool.is_worker_thread(); });
+                auto on_other = pool.post_task<bool>([&other] {
+                    return other.is_worker_thread();
+                });
+
+                EXPECTS(on_pool.get());
+                EXPECTS(not on_other.get());
+            } },
+          { "ThreadPool.task_storage",
+            [] static {
+                auto pool = ThreadPool { 2 };
+
+                // move only callable, stored inline
+                auto value   = std::make_unique<int>(42);
+                auto inlined = pool.post_task<int>([value = std::move(value)] { return *value; });
+
+                // bigger than the inline buffer, stored on the heap
+                auto big   = std::array<int, 64> {};
+                big.back() = 7;
+                auto boxed = pool.post_task<int>([big] { return big.back(); });
+
+                auto thrown = pool.post_task<void>([] { throw std::runtime_error { "error" }; });
+
+                EXPECTS(inlined.get() == 42);
+                EXPECTS(boxed.get() == 7);
+
+                auto has_thrown = false;
+                try {
+                    thrown.get();
+                } catch (const std::runtime_error&) { has_thrown = true; }
+                EXPECTS(has_thrown);
+            } },
+          { "parallel_for",
+            [] static {
+                auto pool   = ThreadPool { 4 };
+                auto values = std::vector<int>(10'000, 1);
+
+                parallel_for(pool, values, [](int& value) { value *= 3; }, 100);
+
+                EXPECTS(std::ranges::all_of(values, [](auto value) { return value == 3; }));
+            } },
+          { "parallel_transform",
+            [] static {
+                auto       pool   = ThreadPool { 4 };
+                const auto values = std::views::iota(0, 10'000) | std::ranges::to<std::vector>();
+
+                const auto doubled = parallel_transform(pool, values, [](int value) {
+                    return value * 2;
+                });
+                const auto odds = parallel_transform_if(
+                  pool,
+                  values,
+                  [](int value) { return value % 2 == 1; },
+                  [](int value) { return value; },
+                  64);
+
+                EXPECTS(std::ranges::equal(doubled, values | std::views::transform([](auto value) {
+                                                        return value * 2;
+                                                    })));
+                EXPECTS(std::size(odds) == 5'000);
+                EXPECTS(std::ranges::is_sorted(odds));
+            } },
+          { "parallel_reduce",
+            [] static {
+                auto       pool   = ThreadPool { 4 };
+                const auto values = std::views::iota(1, 10'001) | std::ranges::to<std::vector>();
+
+                const auto sum = parallel_reduce(pool, values, 0ll, std::plus {}, 128);
+
+                EXPECTS(sum == 50'005'000ll);
+            } },
+          { "parallel_scan",
+            [] static {
+                auto       pool   = ThreadPool { 4 };
+                const auto values = std::vector<int>(10'001, 1);
+                auto       output = std::vector<int>(std::size(values));
+
+                parallel_scan(pool, values, output, std::plus {}, 100);
+
+                auto expected = std::vector<int>(std::size(values));
+                std::inclusive_scan(std::ranges::begin(values),
+                                    std::ranges::end(values),
+                                    std::ranges::begin(expected));
+                EXPECTS(output == expected);
+            } },
+          { "parallel_for.nested",
+            [] static {
+                // every worker block in an outer chunk, inner chunks must still complete
+                auto pool    = ThreadPool { 2 };
+                auto counter = std::atomic<int> { 0 };
+                auto outer   = std::vector<int>(16);
+
+                parallel_for(
+                  pool,
+                  outer,
+                  [&pool, &counter](int&) {
+                      auto inner = std::vector<int>(1'000);
+                      parallel_for(
+                        pool,
+                        inner,
+                        [&counter](int&) { counter.fetch_add(1, std::memory_order_relaxed); },
+                        10);
+                  },
+                  1);
+
+                EXPECTS(counter.load() == 16 * 1'000);
+            } },
+          { "parallel_for.throw_on_helper",
+            [] static {
+                auto pool   = ThreadPool { 1 };
+                auto thrown = std::atomic<bool> { false };
+                auto values = std::vector<int>(2);
+
+                // the caller chunk wait for the helper one, so the helper always throw
+                auto has_thrown = false;
+                try {
+                    parallel_for(
+                      pool,
+                      values,
+                      [&pool, &thrown](int&) {
+                          if (pool.is_worker_thread()) {
+                              thrown.store(true);
+                              thrown.notify_all();
+                              throw std::runtime_error { "helper" };
+                          }
+                          thrown.wait(false);
+                      },
+                      1);
+                } catch (const std::runtime_error& error) {
+                    has_thrown = std::string_view { error.what() } == "helper";
+                }
+                EXPECTS(has_thrown);
+            } },
+          { "parallel_for.throw_on_caller",
+            [] static {
+                auto pool   = ThreadPool { 1 };
+                auto thrown = std::atomic<bool> { false };
+                auto values = std::vector<int>(2);
+
+                // the helper chunk wait for the caller one, it must still be counted before the
+                // caller unwind
+                auto has_thrown = false;
+                try {
+                    parallel_for(
+                      pool,
+                      values,
+                      [&pool, &thrown](int&) {
+                          if (not pool.is_worker_thread()) {
+                              thrown.store(true);
+                              thrown.notify_all();
+                              throw std::runtime_error { "caller" };
+                          }
+                          thrown.wait(false);
+                      },
+                      1);
+                } catch (const std::runtime_error& error) {
+                    has_thrown = std::string_view { error.what() } == "caller";
+                }
+                EXPECTS(has_thrown);
+            } },
+          { "ThreadPool.join_all_drains",
+            [] static {
+                auto counter = std::atomic<int> { 0 };
+                {
+                    auto pool = ThreadPool { 2 };
+                    for (auto _ : range(10'000))
+                        pool.post_task<void>([&counter] { counter.fetch_add(1); },
+                                             ThreadPool::NoFuture);
+                }
+
+                EXPECTS(counter.load() == 10'000);
+            } },
+          { "ThreadPool.stats",
+            [] static {
+                auto pool = ThreadPool { ThreadPool::Config { .worker_count  = 2,
+                                                              .collect_stats = true } };
+                EXPECTS(pool.stats_enabled());
+
+                auto futures = std::vector<std::future<void>> {};
+                for (auto _ : range(1'000))
+                    futures.emplace_back(pool.post_task<void>([] {}));
+                for (auto& future : futures) future.wait();
+
+                auto stats = pool.stats();
+                EXPECTS(std::size(stats) == 2);
+
+                const auto executed = std::ranges::fold_left(stats,
+                                                             u64 { 0 },
+                                                             [](auto acc, const auto& worker) {
+                                                                 return acc + worker.executed_tasks;
+                                                             });
+                EXPECTS(executed == 1'000);
+                EXPECTS(std::ranges::any_of(stats, [](const auto& worker) {
+                    return worker.injected_high_water_mark > 0;
+                }));
+                EXPECTS(std::ranges::all_of(stats, [](const auto& worker) {
+                    return worker.max_start_delay <= worker.total_start_delay;
+                }));
+
+                // tasks posted while disabled are not counted
+                pool.reset_stats();
+                pool.enable_stats(false);
+                pool.post_task<void>([] {}).wait();
+                stats = pool.stats();
+                EXPECTS(std::ranges::all_of(stats, [](const auto& worker) {
+                    return worker.executed_tasks == 0;
+                }));
+            } },
+          }
+    };
+} // namespace
@@ -0,0 +1,65 @@
+// Copyright (C) 2024 Arthur LAURENT <arthur.laurent4@gmail.com>
+// This file is subject to the license terms in the LICENSE file
+// found in the top-level of this distribution
+
+import std;
+
+import stormkit.core;
+import stormkit.test;
+
+#include <stormkit/test/test_macro.hpp>
+
+using namespace stormkit::core;
+
+namespace {
+    auto _ = test::TestSuite {
+        "Core.parallelism",
+        {
+          { "CpuTopology.physical_cores",
+            [] static {
+                const auto& topology = cpu_topology();
+                EXPECTS(not std::empty(topology.cpus));
+                EXPECTS(topology.core_count > 0);
+
+                const auto cores = topology.physical_cores();
+                EXPECTS(std::size(cores) == topology.core_count);
+
+                auto cpus = cores | std::views::join | std::ranges::to<std::vector>();
+                std::ranges::sort(cpus);
+                auto ids = topology.cpus
+                           | std::views::transform(&LogicalCpu::id)
+                           | std::ranges::to<std::vector>();
+                std::ranges::sort(ids);
+                EXPECTS(cpus == ids);
+            } },
+          { "ThreadPool.placement",
+            [] static {
+                for (const auto placement : { ThreadPool::Placement::Unpinned,
+                                              ThreadPool::Placement::Physical_Cores,
+                                              ThreadPool::Placement::Logical_Cpus }) {
+                    auto pool = ThreadPool {
+                        ThreadPool::Config { .worker_count = 4, .placement = placement }
+                    };
+                    EXPECTS(pool.worker_count() == 4);
+
+                    auto futures = std::vector<std::future<int>> {};
+                    for (auto i : range(256))
+                        futures.emplace_back(pool.post_task<int>([i] { return i + 1; }));
+
+                    auto sum = 0;
+                    for (auto& future : futures) sum += future.get();
+                    EXPECTS(sum == 256 * 257 / 2);
+                }
+            } },
+          { "ThreadPool.priority",
+            [] static {
+                auto pool = ThreadPool {
+                    ThreadPool::Config { .worker_count = 2, .priority = ThreadPriority::Low }
+                };
+
+                auto future = pool.post_task<bool>([] { return true; });
+                EXPECTS(future.get());
+            } },
+        }
+    };
+} // namespace
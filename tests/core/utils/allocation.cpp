@@ -24,6 +24,106 @@ namespace {
             [] static noexcept {
                 auto allocation = allocate_unsafe<int>(5);
                 EXPECTS(*allocation == 5);
+            } },
+          { "Allocation.pooled",
+            [] static {
+                auto allocation = allocate_pooled<std::array<u64, 4>>(std::array<u64, 4> {
+                  1,
+                  2,
+                  3,
+                  4 });
+                EXPECTS((*allocation)[3] == 4);
+                EXPECTS(std::bit_cast<std::uintptr_t>(allocation.get()) % 64 == 0);
+            } },
+          { "FrameArena.reset",
+            [] static {
+                auto arena = FrameArena { 256 };
+                EXPECTS(arena.capacity() == 256);
+
+                auto* first = arena.allocate(16, 16);
+                EXPECTS(std::bit_cast<std::uintptr_t>(first) % 16 == 0);
+                EXPECTS(arena.used() >= 16);
+
+                // overflow into a second chunk
+                auto* big = arena.allocate(1024, 8);
+                EXPECTS(big != nullptr);
+                EXPECTS(arena.capacity() >= 256 + 1024);
+
+                // the next frame fits in a single chunk
+                arena.reset();
+                EXPECTS(arena.used() == 0);
+                EXPECTS(arena.capacity() >= 16 + 1024);
+                const auto capacity = arena.capacity();
+
+                auto values = std::pmr::vector<u32> { &arena };
+                for (auto i : range(64u)) values.push_back(i);
+                EXPECTS(values[63] == 63);
+                EXPECTS(arena.capacity() == capacity);
+            } },
+          { "FrameArena.hash_map",
+            [] static {
+                auto arena = FrameArena {};
+                auto map   = pmr::HashMap<u32, std::string> { &arena };
+                for (auto i : range(100u)) map.emplace(i, std::to_string(i));
+                EXPECTS(std::size(map) == 100);
+                EXPECTS(map.at(42) == "42");
+
+                auto set = pmr::HashSet<u32> { &arena };
+                set.emplace(5);
+                EXPECTS(set.contains(5));
+            } },
+          { "PoolResource.allocate",
+            [] static {
+                auto& resource = pool_resource();
+
+                auto* small = resource.allocate(24, 8);
+                auto* large = resource.allocate(4096, 16);
+                EXPECTS(small != nullptr and large != nullptr);
+                resource.deallocate(small, 24, 8);
+                resource.deallocate(large, 4096, 16);
+
+                auto list = std::pmr::list<u64> { &resource };
+                for (auto i : range(1000u)) list.push_back(i);
+                EXPECTS(std::size(list) == 1000);
+                EXPECTS(list.back() == 999);
+            } },
+          { "TlsfResource.allocate",
+            [] static {
+                auto resource = TlsfResource { 4096 };
+
+                auto blocks = std::vector<std::tuple<std::byte*, usize, usize>> {};
+                for (auto i : range(200u)) {
+                    const auto size      = usize { 1 } + (i * 37) % 700;
+                    const auto alignment = usize { 1 } << (i % 8);
+                    auto*      ptr = static_cast<std::byte*>(resource.allocate(size, alignment));
+                    EXPECTS(std::bit_cast<std::uintptr_t>(ptr) % alignment == 0);
+                    std::ranges::fill(std::span { ptr, size }, std::byte { as<u8>(i) });
+                    blocks.emplace_back(ptr, size, alignment);
+                }
+
+                // free every other block so neighbours coalesce, then check the survivors
+                for (auto i = 0uz; i < std::size(blocks); i += 2) {
+                    auto [ptr, size, alignment] = blocks[i];
+                    resource.deallocate(ptr, size, alignment);
+                }
+                auto intact = true;
+                for (auto i = 1uz; i < std::size(blocks); i += 2) {
+                    auto [ptr, size, _] = blocks[i];
+                    intact = intact
+                             and std::ranges::all_of(std::span { ptr, size },
+                                                     monadic::is(std::byte { as<u8>(i) }));
+                }
+                EXPECTS(intact);
+
+                for (auto i = 1uz; i < std::size(blocks); i += 2) {
+                    auto [ptr, size, alignment] = blocks[i];
+                    resource.deallocate(ptr, size, alignment);
+                }
+
+                // bigger than a pool
+                auto values = std::pmr::vector<u64> { &resource };
+                values.resize(10'000, 7);
+                EXPECTS(values.back() == 7);
             } } }
     };
 } // namespace
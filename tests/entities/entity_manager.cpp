@@ -0,0 +1,664 @@
+// Copyright (C) 2024 Arthur LAURENT <arthur.laurent4@gmail.com>
+// This file is subject to the license terms in the LICENSE file
+// found in the top-level of this distribution
+
+import std;
+
+import stormkit.core;
+import stormkit.entities;
+import stormkit.test;
+
+#include <stormkit/test/test_macro.hpp>
+
+using namespace stormkit;
+using namespace stormkit::entities::literals;
+using namespace std::literals;
+
+namespace {
+    struct PositionComponent: entities::Component {
+        static constexpr Type TYPE = "PositionComponent"_component_type;
+
+        u32 x = 0;
+        u32 y = 0;
+    };
+
+    struct VelocityComponent: entities::Component {
+        static constexpr Type TYPE = "VelocityComponent"_component_type;
+
+        i32 dx = 0;
+        i32 dy = 0;
+    };
+
+    struct DamageEvent: entities::Event {
+        static constexpr Type TYPE = "DamageEvent"_event_type;
+
+        entities::Entity target = entities::INVALID_ENTITY;
+        u32              amount = 0;
+    };
+
+    struct UnusedEvent: entities::Event {
+        static constexpr Type TYPE = "UnusedEvent"_event_type;
+    };
+
+    class MoveSystem final: public entities::System {
+      public:
+        explicit MoveSystem(entities::EntityManager& manager)
+            : System { manager,
+                       0,
+                       { PositionComponent::TYPE, VelocityComponent::TYPE },
+                       { .reads  = { VelocityComponent::TYPE },
+                         .writes = { PositionComponent::TYPE } } },
+              m_world { &manager } {}
+
+        auto update(Secondf) -> void override {
+            for (auto e : m_entities)
+                m_world->getComponent<PositionComponent>(e).x += as<u32>(
+                  m_world->read_component<VelocityComponent>(e).dx);
+        }
+
+        std::vector<entities::Message> messages;
+
+      protected:
+        auto on_message_received(const entities::Message& message) -> void override {
+            messages.emplace_back(message);
+        }
+
+      private:
+        entities::EntityManager* m_world;
+    };
+
+    class SumSystem final: public entities::System {
+      public:
+        explicit SumSystem(u32 priority, entities::EntityManager& manager)
+            : System { manager,
+                       priority,
+                       { PositionComponent::TYPE },
+                       { .reads = { PositionComponent::TYPE }, .writes = {} } } {}
+
+        auto update(Secondf) -> void override {
+            sum = 0;
+            for (auto e : m_entities) sum += m_manager->getComponent<PositionComponent>(e).x;
+        }
+
+        u32                            sum = 0;
+        std::vector<entities::Message> messages;
+
+      protected:
+        auto on_message_received(const entities::Message& message) -> void override {
+            messages.emplace_back(message);
+        }
+    };
+
+    /// Record the order in which systems are updated, only read so it never conflicts
+    class OrderSystem final: public entities::System {
+      public:
+        OrderSystem(u32                       priority,
+                    std::atomic<u32>&         counter,
+                    std::chrono::milliseconds delay,
+                    entities::EntityManager&  manager)
+            : System { manager,
+                       priority,
+                       { PositionComponent::TYPE },
+                       { .reads = { PositionComponent::TYPE }, .writes = {} } },
+              m_counter { &counter }, m_delay { delay } {}
+
+        auto update(Secondf) -> void override {
+            std::this_thread::sleep_for(m_delay);
+            order = m_counter->fetch_add(1);
+        }
+
+        u32 order = 0;
+
+      protected:
+        auto on_message_received(const entities::Message&) -> void override {}
+
+      private:
+        std::atomic<u32>*         m_counter;
+        std::chrono::milliseconds m_delay;
+    };
+
+    class ThrowSystem final: public entities::System {
+      public:
+        explicit ThrowSystem(entities::EntityManager& manager)
+            : System { manager,
+                       0,
+                       { PositionComponent::TYPE },
+                       { .reads = { PositionComponent::TYPE }, .writes = {} } } {}
+
+        auto update(Secondf) -> void override { throw std::runtime_error { "update" }; }
+
+      protected:
+        auto on_message_received(const entities::Message&) -> void override {}
+    };
+
+    auto _ = test::TestSuite {
+        "Entities",
+        {
+          { "EntityManager.add_component",
+            [] static {
+                auto manager = entities::EntityManager {};
+
+                const auto e = manager.make_entity();
+                manager.add_component<PositionComponent>(e).x = 4;
+
+                EXPECTS(manager.has_component<PositionComponent>(e));
+                EXPECTS(not manager.has_component<VelocityComponent>(e));
+                EXPECTS(manager.getComponent<PositionComponent>(e).x == 4);
+            } },
+          { "EntityManager.destroy_component",
+            [] static {
+                auto manager = entities::EntityManager {};
+
+                const auto e1 = manager.make_entity();
+                const auto e2 = manager.make_entity();
+                manager.add_component<PositionComponent>(e1).x = 1;
+                manager.add_component<PositionComponent>(e2).x = 2;
+
+                manager.destroy_component<PositionComponent>(e1);
+
+                EXPECTS(not manager.has_component<PositionComponent>(e1));
+                EXPECTS(manager.getComponent<PositionComponent>(e2).x == 2);
+                EXPECTS(std::size(manager.components_of_type<PositionComponent>()) == 1);
+            } },
+          { "EntityManager.stale_handle",
+            [] static {
+                auto manager = entities::EntityManager {};
+
+                const auto e1 = manager.make_entity();
+                manager.add_component<PositionComponent>(e1);
+                manager.step(Secondf { 0.f });
+
+                manager.destroy_entity(e1);
+                manager.step(Secondf { 0.f });
+                EXPECTS(not manager.has_entity(e1));
+
+                const auto e2 = manager.make_entity();
+                EXPECTS(entities::entity_index(e2) == entities::entity_index(e1));
+                EXPECTS(entities::entity_version(e2) != entities::entity_version(e1));
+                EXPECTS(manager.has_entity(e2));
+                EXPECTS(not manager.has_entity(e1));
+                EXPECTS(not manager.has_component<PositionComponent>(e2));
+            } },
+          { "EntityManager.parallel_step",
+            [] static {
+                auto manager = entities::EntityManager {};
+                auto pool    = ThreadPool { 2 };
+
+                for (auto i : range(100u)) {
+                    const auto e                                   = manager.make_entity();
+                    manager.add_component<PositionComponent>(e).x  = i;
+                    manager.add_component<VelocityComponent>(e).dx = 1;
+                }
+
+                manager.add_system<SumSystem>(0u);
+                manager.add_system<MoveSystem>();
+                auto& after = manager.add_system<SumSystem>(1u);
+
+                EXPECTS(manager.get_system<MoveSystem>().conflicts_with(after));
+                EXPECTS(std::size(manager.systems()) == 3);
+
+                manager.step(Secondf { 0.f }, pool);
+                EXPECTS(after.sum == 4950 + 100);
+            } },
+          { "EntityManager.parallel_step_priorities",
+            [] static {
+                auto manager = entities::EntityManager {};
+                auto pool    = ThreadPool { 4 };
+                auto counter = std::atomic<u32> { 0 };
+
+                const auto e = manager.make_entity();
+                manager.add_component<PositionComponent>(e);
+
+                // none of these systems conflict, only their priority order them
+                auto& first  = manager.add_system<OrderSystem>(0u, counter, 20ms);
+                auto& second = manager.add_system<OrderSystem>(1u, counter, 10ms);
+                auto& third  = manager.add_system<OrderSystem>(1u, counter, 10ms);
+                auto& last   = manager.add_system<OrderSystem>(2u, counter, 0ms);
+                EXPECTS(not first.conflicts_with(last));
+
+                manager.step(Secondf { 0.f }, pool);
+                EXPECTS(first.order == 0);
+                EXPECTS(std::ranges::min(second.order, third.order) == 1);
+                EXPECTS(std::ranges::max(second.order, third.order) == 2);
+                EXPECTS(last.order == 3);
+            } },
+          { "EntityManager.parallel_step_exception",
+            [] static {
+                auto manager = entities::EntityManager {};
+                auto pool    = ThreadPool { 2 };
+                auto counter = std::atomic<u32> { 0 };
+
+                const auto e = manager.make_entity();
+                manager.add_component<PositionComponent>(e);
+
+                manager.add_system<ThrowSystem>();
+                manager.add_system<OrderSystem>(1u, counter, 0ms);
+
+                auto has_thrown = false;
+                try {
+                    manager.step(Secondf { 0.f }, pool);
+                } catch (const std::runtime_error&) { has_thrown = true; }
+
+                // the system depending on the failed one is skipped
+                EXPECTS(has_thrown);
+                EXPECTS(counter.load() == 0);
+
+                // structural changes are allowed again once the step is over
+                EXPECTS(manager.make_entity() != entities::INVALID_ENTITY);
+            } },
+          { "System.parallel_each",
+            [] static {
+                auto manager = entities::EntityManager {};
+                auto pool    = ThreadPool { 2 };
+
+                for (auto i : range(1000u)) {
+                    const auto e                                   = manager.make_entity();
+                    manager.add_component<PositionComponent>(e).x  = i;
+                    manager.add_component<VelocityComponent>(e).dx = 2;
+                }
+
+                auto& system = manager.add_system<SumSystem>(0u);
+                manager.step(Secondf { 0.f });
+
+                system.parallel_each(
+                  pool,
+                  [&manager](auto e) {
+                      manager.getComponent<PositionComponent>(e).x += as<u32>(
+                        manager.getComponent<VelocityComponent>(e).dx);
+                  },
+                  64);
+
+                const auto sum = system.parallel_each(
+                  pool,
+                  0u,
+                  [&manager](u32& acc, auto e) {
+                      acc += manager.getComponent<PositionComponent>(e).x;
+                  },
+                  std::plus<u32> {},
+                  64);
+                EXPECTS(sum == 499500 + 2000);
+            } },
+          { "EntityCommandBuffer.apply",
+            [] static {
+                auto manager = entities::EntityManager {};
+
+                const auto existing = manager.make_entity();
+                manager.add_component<PositionComponent>(existing);
+                manager.step(Secondf { 0.f });
+
+                auto buffer = manager.make_command_buffer();
+                for (auto i : range(100u)) {
+                    const auto e = buffer.make_entity();
+                    EXPECTS(entities::EntityCommandBuffer::is_deferred(e));
+                    buffer.add_component<PositionComponent>(e).x = i;
+                }
+                buffer.destroy_component<PositionComponent>(existing);
+                buffer.add_component<VelocityComponent>(existing).dx = 3;
+                EXPECTS(std::size(buffer) == 202);
+
+                manager.submit(std::move(buffer));
+                EXPECTS(manager.entity_count() == 1);
+
+                manager.step(Secondf { 0.f });
+                EXPECTS(manager.entity_count() == 101);
+                EXPECTS(std::size(manager.components_of_type<PositionComponent>()) == 100);
+                EXPECTS(not manager.has_component<PositionComponent>(existing));
+                EXPECTS(manager.getComponent<VelocityComponent>(existing).dx == 3);
+
+                auto destroy = manager.make_command_buffer();
+                EXPECTS(std::empty(destroy));
+                destroy.destroy_entity(existing);
+                manager.submit(std::move(destroy));
+                manager.step(Secondf { 0.f });
+                EXPECTS(not manager.has_entity(existing));
+                EXPECTS(manager.entity_count() == 100);
+            } },
+          { "EntityCommandBuffer.recorded_order",
+            [] static {
+                auto manager = entities::EntityManager {};
+
+                const auto existing = manager.make_entity();
+                manager.add_component<PositionComponent>(existing).x = 1;
+                manager.step(Secondf { 0.f });
+
+                auto buffer = manager.make_command_buffer();
+                buffer.destroy_component<PositionComponent>(existing);
+                buffer.add_component<PositionComponent>(existing).x = 2;
+                const auto e = buffer.make_entity();
+                buffer.add_component<PositionComponent>(e).x = 3;
+                buffer.destroy_component<PositionComponent>(e);
+                buffer.add_component<VelocityComponent>(e);
+                manager.submit(std::move(buffer));
+                manager.step(Secondf { 0.f });
+
+                EXPECTS(manager.getComponent<PositionComponent>(existing).x == 2);
+                EXPECTS(std::size(manager.components_of_type<PositionComponent>()) == 1);
+                EXPECTS(std::size(manager.components_of_type<VelocityComponent>()) == 1);
+            } },
+          { "System.messages",
+            [] static {
+                auto  manager   = entities::EntityManager {};
+                auto& positions = manager.add_system<SumSystem>(0u);
+                auto& movers    = manager.add_system<MoveSystem>();
+
+                const auto e1 = manager.make_entity();
+                const auto e2 = manager.make_entity();
+                const auto e3 = manager.make_entity();
+                manager.add_component<PositionComponent>(e1);
+                manager.add_component<PositionComponent>(e2);
+                manager.add_component<VelocityComponent>(e2);
+                manager.add_component<VelocityComponent>(e3);
+                manager.step(Secondf { 0.f });
+
+                // each system is only told about the entities it gained
+                EXPECTS(std::size(positions.messages) == 1);
+                EXPECTS(positions.messages[0].id
+                        == entities::EntityManager::ADDED_ENTITY_MESSAGE_ID);
+                EXPECTS(std::size(positions.messages[0].entities) == 2);
+                EXPECTS(std::size(movers.messages) == 1);
+                EXPECTS(std::ranges::equal(movers.messages[0].entities, std::array { e2 }));
+
+                positions.messages.clear();
+                movers.messages.clear();
+                manager.destroy_entity(e1);
+                manager.destroy_entity(e3);
+                manager.destroy_entity(manager.make_entity());
+                manager.step(Secondf { 0.f });
+
+                EXPECTS(std::size(positions.messages) == 1);
+                EXPECTS(positions.messages[0].id
+                        == entities::EntityManager::REMOVED_ENTITY_MESSAGE_ID);
+                EXPECTS(std::ranges::equal(positions.messages[0].entities, std::array { e1 }));
+                EXPECTS(std::empty(movers.messages));
+            } },
+          { "System.membership_deltas",
+            [] static {
+                auto manager = entities::EntityManager {};
+                auto& system = manager.add_system<SumSystem>(0u);
+
+                const auto e1 = manager.make_entity();
+                const auto e2 = manager.make_entity();
+                const auto e3 = manager.make_entity();
+                manager.add_component<PositionComponent>(e1);
+                manager.add_component<PositionComponent>(e2);
+                manager.add_component<VelocityComponent>(e3);
+                manager.step(Secondf { 0.f });
+                EXPECTS(std::size(system.added_entities()) == 2);
+                EXPECTS(std::empty(system.removed_entities()));
+
+                manager.destroy_component<PositionComponent>(e1);
+                manager.add_component<VelocityComponent>(e2);
+                manager.step(Secondf { 0.f });
+                EXPECTS(std::empty(system.added_entities()));
+                EXPECTS(std::size(system.removed_entities()) == 1);
+                EXPECTS(system.removed_entities()[0] == e1);
+
+                auto& late = manager.add_system<MoveSystem>();
+                EXPECTS(std::size(late.added_entities()) == 1);
+                EXPECTS(late.added_entities()[0] == e2);
+
+                manager.destroy_entity(e2);
+                manager.step(Secondf { 0.f });
+                EXPECTS(std::size(system.removed_entities()) == 1);
+                EXPECTS(std::size(late.removed_entities()) == 1);
+            } },
+          { "EntityManager.events",
+            [] static {
+                auto manager = entities::EntityManager {};
+                auto pool    = ThreadPool { 4 };
+
+                auto& channel = manager.subscribe<DamageEvent>();
+                manager.publish(UnusedEvent {});
+                EXPECTS(std::empty(manager.events<UnusedEvent>()));
+
+                constexpr auto EVENT_COUNT = entities::EventChannel<DamageEvent>::DEFAULT_CAPACITY
+                                             * 2;
+                auto latch = std::latch { as<std::ptrdiff_t>(EVENT_COUNT) };
+                for (auto i : range(EVENT_COUNT))
+                    pool.post_task<void>(
+                      [&manager, &latch, i] {
+                          auto event   = DamageEvent {};
+                          event.target = 1;
+                          event.amount = as<u32>(i);
+                          manager.publish(std::move(event));
+                          latch.count_down();
+                      },
+                      ThreadPool::NoFuture);
+                latch.wait();
+
+                EXPECTS(std::empty(manager.events<DamageEvent>()));
+
+                manager.step(Secondf { 0.f });
+                const auto events = manager.events<DamageEvent>();
+                EXPECTS(std::size(events) == EVENT_COUNT);
+                EXPECTS(std::ranges::fold_left(events, 0uz, [](auto acc, const auto& event) {
+                            return acc + event.amount;
+                        })
+                        == EVENT_COUNT * (EVENT_COUNT - 1) / 2);
+                EXPECTS(channel.capacity() >= EVENT_COUNT);
+
+                manager.step(Secondf { 0.f });
+                EXPECTS(std::empty(manager.events<DamageEvent>()));
+            } },
+          { "EntityManager.snapshot",
+            [] static {
+                auto manager = entities::EntityManager {};
+                auto& system = manager.add_system<SumSystem>(0u);
+
+                auto entities = std::vector<entities::Entity> {};
+                for (auto i : range(2000u)) {
+                    const auto e                                  = manager.make_entity();
+                    manager.add_component<PositionComponent>(e).x = i;
+                    entities.emplace_back(e);
+                }
+                manager.destroy_entity(entities[10]);
+                manager.step(Secondf { 0.f });
+
+                const auto base = manager.snapshot();
+                EXPECTS(std::size(base) == manager.snapshot_size());
+
+                manager.getComponent<PositionComponent>(entities[0]).x = 42;
+                const auto current = manager.snapshot();
+                const auto delta   = entities::make_delta_snapshot(base, current);
+                EXPECTS(std::size(delta) < std::size(current));
+
+                const auto rebuilt = entities::apply_delta_snapshot(base, delta);
+                EXPECTS(rebuilt.has_value());
+                EXPECTS(std::ranges::equal(*rebuilt, current));
+
+                for (auto e : entities | std::views::drop(1000)) manager.destroy_entity(e);
+                manager.step(Secondf { 0.f });
+                EXPECTS(manager.entity_count() == 1000);
+
+                EXPECTS(manager.restore(base).has_value());
+                EXPECTS(manager.entity_count() == 1999);
+                EXPECTS(not manager.has_entity(entities[10]));
+                EXPECTS(manager.has_entity(entities[1500]));
+                EXPECTS(manager.getComponent<PositionComponent>(entities[1500]).x == 1500);
+                EXPECTS(manager.getComponent<PositionComponent>(entities[0]).x == 0);
+                EXPECTS(std::size(system.added_entities()) == 1999);
+
+                auto other = entities::EntityManager {};
+                EXPECTS(other.restore(base).error()
+                        == entities::SnapshotError::Unknown_Component_Type);
+                other.register_component<PositionComponent>();
+                EXPECTS(other.restore(base).has_value());
+                EXPECTS(other.entity_count() == 1999);
+
+                EXPECTS(not other.restore(std::span { base }.first(8)).has_value());
+
+                // a component stored for a stale entity is rejected before touching the world
+                constexpr auto align = [](usize offset) static noexcept {
+                    return (offset + entities::SNAPSHOT_ALIGNMENT - 1)
+                           & ~(entities::SNAPSHOT_ALIGNMENT - 1);
+                };
+                // slot 0 is never handed out, the snapshot hold 2001 slots
+                constexpr auto SLOT_COUNT = 2001uz;
+
+                auto       corrupted      = base;
+                const auto version_offset = align(sizeof(entities::SnapshotHeader));
+                corrupted[version_offset + sizeof(u32)] ^= std::byte { 0xff };
+                EXPECTS(other.restore(corrupted).error() == entities::SnapshotError::Invalid_Entity);
+                EXPECTS(other.entity_count() == 1999);
+
+                // slot 0 alive would put INVALID_ENTITY in the world
+                const auto alive_offset = align(version_offset + SLOT_COUNT * sizeof(u32));
+                corrupted               = base;
+                corrupted[alive_offset] |= std::byte { 1 };
+                EXPECTS(other.restore(corrupted).error()
+                        == entities::SnapshotError::Invalid_Entity);
+
+                // a free slot which is still alive would be handed out twice
+                const auto free_offset = align(alive_offset
+                                               + (SLOT_COUNT + 63) / 64 * sizeof(u64));
+                const auto alive_index = entities::entity_index(entities[0]);
+                corrupted              = base;
+                std::ranges::copy(std::as_bytes(std::span { &alive_index, 1 }),
+                                  std::begin(corrupted) + as<std::ptrdiff_t>(free_offset));
+                EXPECTS(other.restore(corrupted).error()
+                        == entities::SnapshotError::Invalid_Entity);
+
+                // a storage count which doesn't fit in the blob
+                // SnapshotStorageHeader::count follow the type and the component size
+                const auto storage_offset = align(free_offset + sizeof(u32));
+                const auto count_offset   = storage_offset + sizeof(entities::Component::Type)
+                                          + sizeof(u32);
+                corrupted                 = base;
+                std::ranges::fill(std::span { corrupted }.subspan(count_offset, sizeof(u32)),
+                                  std::byte { 0xff });
+                EXPECTS(other.restore(corrupted).error() == entities::SnapshotError::Truncated);
+                EXPECTS(other.entity_count() == 1999);
+
+                // the same entity listed twice in a storage
+                const auto stored_offset = storage_offset
+                                           + align(sizeof(entities::SnapshotStorageHeader));
+                corrupted                = base;
+                std::ranges::copy(std::span { corrupted }.subspan(stored_offset,
+                                                                  sizeof(entities::Entity)),
+                                  std::begin(corrupted)
+                                    + as<std::ptrdiff_t>(stored_offset + sizeof(entities::Entity)));
+                EXPECTS(other.restore(corrupted).error()
+                        == entities::SnapshotError::Invalid_Entity);
+                EXPECTS(other.entity_count() == 1999);
+
+                // DeltaHeader::size follow the magic and the version
+                const auto poke_size = [](std::vector<std::byte> delta, u64 size) static {
+                    std::ranges::copy(std::as_bytes(std::span { &size, 1 }),
+                                      std::begin(delta) + as<std::ptrdiff_t>(2 * sizeof(u32)));
+                    return delta;
+                };
+                // a size which the listed blocks can't fill
+                EXPECTS(entities::apply_delta_snapshot(base, poke_size(delta, u64 { 1 } << 40))
+                          .error()
+                        == entities::SnapshotError::Truncated);
+                // the changed block doesn't hold the bytes past the base
+                EXPECTS(entities::apply_delta_snapshot(base, poke_size(delta, std::size(base) + 16))
+                          .error()
+                        == entities::SnapshotError::Truncated);
+
+                // same size but different content
+                EXPECTS(entities::apply_delta_snapshot(current, delta).error()
+                        == entities::SnapshotError::Base_Mismatch);
+            } },
+          { "Query.filters",
+            [] static {
+                auto manager = entities::EntityManager {};
+
+                auto& moving  = manager.make_query<entities::Write<PositionComponent>,
+                                                   entities::Read<VelocityComponent>>();
+                auto& still   = manager.make_query<entities::Read<PositionComponent>,
+                                                   entities::Without<VelocityComponent>>();
+                auto& moved   = manager.make_query<entities::Changed<PositionComponent>>();
+                auto& spawned = manager.make_query<entities::Added<VelocityComponent>>();
+
+                auto handles = std::vector<entities::Entity> {};
+                for (auto i : range(1000u)) {
+                    const auto e                                  = manager.make_entity();
+                    manager.add_component<PositionComponent>(e).x = i;
+                    if (i < 300) manager.add_component<VelocityComponent>(e).dx = 1;
+                    handles.emplace_back(e);
+                }
+                manager.step(Secondf { 0.f });
+
+                EXPECTS(std::size(moving) == 300);
+                EXPECTS(std::size(still) == 700);
+
+                auto count = 0u;
+                spawned.for_each([&count](auto, const auto&) { ++count; });
+                EXPECTS(count == 300);
+                count = 0;
+                spawned.for_each([&count](auto, const auto&) { ++count; });
+                EXPECTS(count == 0);
+
+                count = 0;
+                moved.for_each([&count](auto, const auto&) { ++count; });
+                EXPECTS(count == 1000);
+                count = 0;
+                moved.for_each([&count](auto, const auto&) { ++count; });
+                EXPECTS(count == 0);
+
+                moving.for_each([](auto, PositionComponent& position, const auto& velocity) {
+                    position.x += as<u32>(velocity.dx);
+                });
+                EXPECTS(manager.getComponent<PositionComponent>(handles[0]).x == 1);
+
+                // only the chunks holding the 300 first entities were written
+                count = 0;
+                moved.for_each([&count](auto, const auto&) { ++count; });
+                EXPECTS(count >= 300 and count < 1000);
+
+                manager.getComponent<PositionComponent>(handles[999]).x = 0;
+                count = 0;
+                moved.for_each([&count](auto, const auto&) { ++count; });
+                EXPECTS(count > 0 and count <= entities::details::ComponentStorageBase::CHUNK_SIZE);
+
+                // reads don't mark anything, writes through a view do
+                EXPECTS(manager.read_component<PositionComponent>(handles[0]).x == 1);
+                for (auto&& [position] : std::as_const(manager).view<PositionComponent>())
+                    EXPECTS(position.x < 1000);
+                count = 0;
+                moved.for_each([&count](auto, const auto&) { ++count; });
+                EXPECTS(count == 0);
+
+                for (auto&& [position] : manager.view<const PositionComponent>())
+                    EXPECTS(position.x < 1000);
+                count = 0;
+                moved.for_each([&count](auto, const auto&) { ++count; });
+                EXPECTS(count == 0);
+
+                for (auto&& [position] : manager.view<PositionComponent>()) position.x += 1;
+                count = 0;
+                moved.for_each([&count](auto, const auto&) { ++count; });
+                EXPECTS(count == 1000);
+
+                manager.destroy_component<VelocityComponent>(handles[0]);
+                manager.step(Secondf { 0.f });
+                EXPECTS(std::size(moving) == 299);
+                EXPECTS(std::size(still) == 701);
+            } },
+          { "EntityManager.view",
+            [] static {
+                auto manager = entities::EntityManager {};
+
+                for (auto i : range(10u)) {
+                    const auto e                                   = manager.make_entity();
+                    manager.add_component<PositionComponent>(e).x = i;
+                    if (i % 2 == 0) manager.add_component<VelocityComponent>(e).dx = 1;
+                }
+
+                auto count = 0u;
+                for (auto&& [position, velocity] :
+                     manager.view<PositionComponent, VelocityComponent>()) {
+                    position.x += as<u32>(velocity.dx);
+                    ++count;
+                }
+                EXPECTS(count == 5);
+
+                auto sum = 0u;
+                for (auto&& [position] : std::as_const(manager).view<PositionComponent>())
+                    sum += position.x;
+                EXPECTS(sum == 45 + 5);
+            } },
+          }
+    };
+} // namespace
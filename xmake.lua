@@ -42,10 +42,7 @@ add_rules(
 if not is_plat("windows") or not is_plat("mingw") then add_rules("mode.valgrind") end
 
 set_fpmodels("fast")
-add_vectorexts("fma")
-add_vectorexts("neon")
-add_vectorexts("avx", "avx2")
-add_vectorexts("sse", "sse2", "sse3", "ssse3", "sse4.2")
+-- the instruction set is selected per target by the stormkit.flags rule from the simd option
 
 ---------------------------- options ----------------------------
 includes("xmake/options.lua")
@@ -70,7 +67,7 @@ includes("xmake/targets.lua")
 
 ---------------------------- dependencies ----------------------------
 for name, module in pairs(modules) do
-    if name == "core" or name == "main" or name == "test" or get_config(name) then
+    if name == "core" or name == "main" or name == "test" or get_config(name) or (name == "bench" and get_config("benchmarks")) then
         for _, package in ipairs(module.public_packages) do
             add_requires_with_conf_transitive(package)
         end
@@ -84,13 +81,13 @@ end
 for name, module in pairs(modules) do
     local modulename = module.modulename
 
-    if name == "core" or name == "main" or name == "test" or get_config(name) then
+    if name == "core" or name == "main" or name == "test" or get_config(name) or (name == "bench" and get_config("benchmarks")) then
         target("stormkit-" .. name, function()
             set_group("libraries")
 
             if module.custom then module.custom() end
 
-            if name == "main" or name == "test" then
+            if name == "main" or name == "test" or name == "bench" then
                 set_kind("static")
             else
                 set_kind("$(kind)")
@@ -229,4 +226,5 @@ for name, _ in pairs(modules) do
 end
 
 if get_config("tests") then includes("xmake/tests.lua") end
+if get_config("benchmarks") then includes("xmake/benchmarks.lua") end
 if get_config("tools") then includes("tools/**.lua") end
@@ -0,0 +1,27 @@
+includes("targets.lua")
+
+for name, _ in pairs(modules) do
+    if name ~= "test" and name ~= "bench" then
+        for _, file in ipairs(os.files(path.join(os.projectdir(), "benchmarks", name, "**.cpp"))) do
+            local benchname = path.basename(file)
+
+            target(name .. "-" .. benchname .. "-benchmarks", function()
+                set_group("benchmarks")
+                set_kind("binary")
+                set_languages("cxxlatest", "clatest")
+
+                add_rules("stormkit.flags")
+                add_rules("platform.windows.subsystem.console")
+
+                add_files(file)
+
+                add_packages("frozen")
+                add_deps("stormkit-main", "stormkit-bench")
+                add_deps("stormkit-" .. name)
+
+                -- run every benchmark once so `xmake test` catches the ones which crash
+                add_tests("smoke", { runargs = "--smoke" })
+            end)
+        end
+    end
+end
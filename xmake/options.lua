@@ -46,9 +46,12 @@ option("tools", {
     category = "root menu/others",
 })
 option("tests", { default = false, category = "root menu/others" })
+option("benchmarks", { default = false, category = "root menu/others" })
 option("sanitizers", { default = false, category = "root menu/build" })
 option("mold", { default = false, category = "root menu/build" })
 option("lto", { default = false, category = "root menu/build" })
+-- instruction set of the math kernels, "none" builds the scalar fallback on the sse4.2 baseline
+option("simd", { default = "avx2", values = { "avx2", "sse4", "none" }, category = "root menu/build" })
 option("shared_deps", { default = false, category = "root menu/build" })
 option("on_ci", { default = false, category = "root menu/build" })
 
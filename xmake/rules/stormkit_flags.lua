@@ -48,9 +48,13 @@ rule("stormkit.flags", function()
             target_set(target, "symbols", "debug", "hidden")
         end
         target_set(target, "fpmodels", "fast")
-        target_add(target, "vectorexts", "fma")
+        local simd = get_config("simd") or "avx2"
+        if simd == "none" then target_add(target, "defines", "STORMKIT_NO_SIMD") end
+        if simd == "avx2" then
+            target_add(target, "vectorexts", "fma")
+            target_add(target, "vectorexts", "avx", "avx2")
+        end
         target_add(target, "vectorexts", "neon")
-        target_add(target, "vectorexts", "avx", "avx2")
         target_add(target, "vectorexts", "sse", "sse2", "sse3", "ssse3", "sse4.2")
 
         local flags = {
@@ -54,6 +54,10 @@ modules = {
         public_deps = { "stormkit-core" },
         has_headers = true
     },
+    bench = {
+        modulename = "bench",
+        public_deps = { "stormkit-core" },
+    },
     log = {
         modulename = "log",
         public_deps = { "stormkit-core" },